@@ -0,0 +1,207 @@
+#include "AllocationTracker.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Eero {
+
+	// Fixed open-addressing table keyed by the zone's name pointer, slots are claimed with a CAS
+	struct ZoneSlot
+	{
+		std::atomic<const char*> Zone = nullptr;
+		std::atomic<uint64_t> FrameCount = 0, FrameBytes = 0;
+		std::atomic<uint64_t> TotalCount = 0, TotalBytes = 0;
+	};
+
+	static constexpr size_t s_ZoneSlots = 256;
+
+	static ZoneSlot s_Zones[s_ZoneSlots];
+	static ZoneSlot s_NoZone; // outside of any zone, or the table is full
+
+	static std::atomic<uint64_t> s_FrameCount = 0, s_FrameBytes = 0, s_FrameFrees = 0;
+	static std::atomic<uint64_t> s_TotalCount = 0, s_TotalBytes = 0;
+	static std::atomic<int64_t> s_LiveBytes = 0, s_PeakBytes = 0;
+
+	static ZoneSlot& FindZone(const char* zone)
+	{
+		if (!zone)
+			return s_NoZone;
+
+		size_t start = (reinterpret_cast<uintptr_t>(zone) >> 4) & (s_ZoneSlots - 1);
+
+		for (size_t probe = 0; probe < s_ZoneSlots; probe++)
+		{
+			ZoneSlot& slot = s_Zones[(start + probe) & (s_ZoneSlots - 1)];
+			const char* current = slot.Zone.load(std::memory_order_acquire);
+
+			if (current == zone)
+				return slot;
+
+			if (!current && slot.Zone.compare_exchange_strong(current, zone, std::memory_order_acq_rel))
+				return slot;
+
+			// Someone else claimed it in between, it might have been for this zone
+			if (current == zone)
+				return slot;
+		}
+
+		return s_NoZone;
+	}
+
+	template<typename Func>
+	static void ForEachZone(Func func)
+	{
+		for (auto& slot : s_Zones)
+		{
+			if (slot.Zone.load(std::memory_order_acquire))
+				func(slot);
+		}
+
+		func(s_NoZone);
+	}
+
+	static void InsertTop(std::array<ZoneAllocations, 3>& top, const ZoneAllocations& zone)
+	{
+		for (size_t i = 0; i < top.size(); i++)
+		{
+			if (zone.Count > top[i].Count)
+			{
+				for (size_t j = top.size() - 1; j > i; j--)
+				{
+					top[j] = top[j - 1];
+				}
+
+				top[i] = zone;
+				return;
+			}
+		}
+	}
+
+	void AllocationTracker::OnAllocate(size_t size)
+	{
+		s_FrameCount.fetch_add(1, std::memory_order_relaxed);
+		s_FrameBytes.fetch_add(size, std::memory_order_relaxed);
+		s_TotalCount.fetch_add(1, std::memory_order_relaxed);
+		s_TotalBytes.fetch_add(size, std::memory_order_relaxed);
+
+		int64_t live = s_LiveBytes.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+		int64_t peak = s_PeakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !s_PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+		ZoneSlot& zone = FindZone(Profiler::GetCurrentZone());
+		zone.FrameCount.fetch_add(1, std::memory_order_relaxed);
+		zone.FrameBytes.fetch_add(size, std::memory_order_relaxed);
+		zone.TotalCount.fetch_add(1, std::memory_order_relaxed);
+		zone.TotalBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::OnFree(size_t size)
+	{
+		s_FrameFrees.fetch_add(1, std::memory_order_relaxed);
+		s_LiveBytes.fetch_sub((int64_t)size, std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::BeginFrame()
+	{
+		s_FrameCount.store(0, std::memory_order_relaxed);
+		s_FrameBytes.store(0, std::memory_order_relaxed);
+		s_FrameFrees.store(0, std::memory_order_relaxed);
+
+		ForEachZone([](ZoneSlot& slot)
+		{
+			slot.FrameCount.store(0, std::memory_order_relaxed);
+			slot.FrameBytes.store(0, std::memory_order_relaxed);
+		});
+	}
+
+	AllocationFrame AllocationTracker::EndFrame()
+	{
+		AllocationFrame frame;
+		frame.Count = s_FrameCount.load(std::memory_order_relaxed);
+		frame.Bytes = s_FrameBytes.load(std::memory_order_relaxed);
+		frame.Frees = s_FrameFrees.load(std::memory_order_relaxed);
+		frame.LiveBytes = s_LiveBytes.load(std::memory_order_relaxed);
+
+		ForEachZone([&](ZoneSlot& slot)
+		{
+			InsertTop(frame.TopZones, { slot.Zone.load(std::memory_order_relaxed), slot.FrameCount.load(std::memory_order_relaxed), slot.FrameBytes.load(std::memory_order_relaxed) });
+		});
+
+		return frame;
+	}
+
+	uint64_t AllocationTracker::GetTotalCount() { return s_TotalCount.load(std::memory_order_relaxed); }
+	uint64_t AllocationTracker::GetTotalBytes() { return s_TotalBytes.load(std::memory_order_relaxed); }
+	int64_t AllocationTracker::GetPeakBytes() { return s_PeakBytes.load(std::memory_order_relaxed); }
+
+	std::array<ZoneAllocations, 3> AllocationTracker::GetTopZones()
+	{
+		std::array<ZoneAllocations, 3> top;
+
+		ForEachZone([&](ZoneSlot& slot)
+		{
+			InsertTop(top, { slot.Zone.load(std::memory_order_relaxed), slot.TotalCount.load(std::memory_order_relaxed), slot.TotalBytes.load(std::memory_order_relaxed) });
+		});
+
+		return top;
+	}
+
+}
+
+#ifdef EERO_TRACK_ALLOCATIONS
+
+// Every block starts with a header holding its size, big enough to keep the default alignment
+static constexpr size_t s_HeaderSize = __STDCPP_DEFAULT_NEW_ALIGNMENT__ > sizeof(size_t) ? __STDCPP_DEFAULT_NEW_ALIGNMENT__ : sizeof(size_t);
+
+static void* TrackedAllocate(size_t size) noexcept
+{
+	void* block = std::malloc(size + s_HeaderSize);
+	if (!block)
+		return nullptr;
+
+	*static_cast<size_t*>(block) = size;
+	Eero::AllocationTracker::OnAllocate(size);
+
+	return static_cast<char*>(block) + s_HeaderSize;
+}
+
+static void TrackedFree(void* memory) noexcept
+{
+	if (!memory)
+		return;
+
+	void* block = static_cast<char*>(memory) - s_HeaderSize;
+	Eero::AllocationTracker::OnFree(*static_cast<size_t*>(block));
+
+	std::free(block);
+}
+
+void* operator new(size_t size)
+{
+	if (void* memory = TrackedAllocate(size))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	if (void* memory = TrackedAllocate(size))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+
+void operator delete(void* memory) noexcept { TrackedFree(memory); }
+void operator delete[](void* memory) noexcept { TrackedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { TrackedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { TrackedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { TrackedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { TrackedFree(memory); }
+
+#endif
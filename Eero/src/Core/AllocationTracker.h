@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace Eero {
+
+	struct ZoneAllocations
+	{
+		const char* Zone = nullptr; // profiler zone, null outside of any zone
+		uint64_t Count = 0;
+		uint64_t Bytes = 0;
+	};
+
+	struct AllocationFrame
+	{
+		uint64_t Count = 0; // allocations of the frame, every thread
+		uint64_t Bytes = 0;
+		uint64_t Frees = 0;
+		int64_t LiveBytes = 0;
+
+		// Zones that allocated the most during the frame
+		std::array<ZoneAllocations, 3> TopZones;
+	};
+
+	// Counts every heap allocation through global operator new/delete, which are only replaced
+	// when EERO_TRACK_ALLOCATIONS is defined (premake --track-allocations). Allocations are
+	// attributed to the profiler zone open on the allocating thread, the zones are kept even
+	// without EERO_PROFILE. Counting is a few relaxed atomics and never allocates itself.
+	// Without tracking every call here reports zeros.
+	class AllocationTracker
+	{
+	public:
+#ifdef EERO_TRACK_ALLOCATIONS
+		static constexpr bool Enabled = true;
+#else
+		static constexpr bool Enabled = false;
+#endif
+
+		static void BeginFrame();
+		static AllocationFrame EndFrame();
+
+		// Whole run
+		static uint64_t GetTotalCount();
+		static uint64_t GetTotalBytes();
+		static int64_t GetPeakBytes();
+		static std::array<ZoneAllocations, 3> GetTopZones();
+
+		// Called by the replaced operators
+		static void OnAllocate(size_t size);
+		static void OnFree(size_t size);
+	};
+
+}
@@ -1,5 +1,12 @@
 #include "Application.h"
 #include "ECS/Systems.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <thread>
 
 namespace Eero {
 
@@ -7,8 +14,13 @@ namespace Eero {
 	std::shared_ptr<Input> Application::s_Input = nullptr;
 	std::shared_ptr<Window> Application::s_Window = nullptr;
 	std::shared_ptr<Collision> Application::s_Collision = nullptr;
+	std::shared_ptr<JobSystem> Application::s_Jobs = nullptr;
+	std::shared_ptr<Scheduler> Application::s_Scheduler = nullptr;
+	std::shared_ptr<TweenEngine> Application::s_Tweens = nullptr;
+	std::shared_ptr<ParticleSystem> Application::s_Particles = nullptr;
 
 	Application::Application(const AppProps& props)
+		: m_Props(props)
 	{
 		Init(props);
 	}
@@ -20,79 +32,248 @@ namespace Eero {
 
 	void Application::Init(const AppProps& props)
 	{
-		m_Window = std::make_shared<Window>(props.WindowTitle, props.WindowWidth, props.WindowHeight);
-		m_Events = std::make_shared<EventHandler>(m_Window->GetWindow());
+		EERO_PROFILE_BEGIN_SESSION(props.WindowTitle, props.ProfilePath);
+
+		Time::SetFixedTimestep(props.FixedTimestep);
+
+		m_Window = std::make_shared<Window>(props.WindowTitle, props.WindowWidth, props.WindowHeight, props.Headless);
+
+		// The window belongs to the input thread, it's open once Start returns
+		if (!props.Headless)
+		{
+			m_InputThread = std::make_shared<InputThread>(m_Window);
+			m_InputThread->Start();
+		}
+
+		m_Events = std::make_shared<EventHandler>(m_InputThread);
 		m_Entities = std::make_shared<EntityManager>();
 		m_Input = std::make_shared<Input>();
+		m_Jobs = std::make_shared<JobSystem>();
 
-		SystemsProps systemsProps = { m_Window->GetWindow(), m_Entities };
+		SystemsProps systemsProps = { m_Window, m_Entities, m_Jobs };
 		m_Systems = std::make_shared<Systems>(systemsProps);
 
 		s_Entities = m_Entities;
 		s_Input = m_Input;
 		s_Window = m_Window;
 		s_Collision = m_Systems->GetCollision();
+		s_Jobs = m_Jobs;
+		s_Scheduler = m_Systems->GetScheduler();
+		s_Tweens = m_Systems->GetTweens();
+		s_Particles = m_Systems->GetParticles();
+
+		if (!props.Headless)
+		{
+			m_RenderThread = std::make_shared<RenderThread>(m_Window, props.FixedTimestep);
+			m_RenderThread->Start();
+		}
 	}
 
 	void Application::Shutdown()
 	{
+		// Drawing stops before anything it reads goes away
+		if (m_RenderThread)
+			m_RenderThread->Stop();
+
+		if (m_Props.ReportLatency && m_RenderThread)
+			PrintLatency();
+
+		if constexpr (AllocationTracker::Enabled)
+			PrintAllocations();
+
 		for (auto& layer : m_Layers)
 		{
 			layer->OnDetach();
 		}
 
+		// Closes the window on the thread that opened it
+		if (m_InputThread)
+			m_InputThread->Stop();
+
 		m_Window->Shutdown();
+
+		// Every thread that records has stopped or is idle by now
+		EERO_PROFILE_END_SESSION();
 	}
 
-	void Application::Run()
+	int Application::Run()
 	{
+		if (m_Props.VerifyCollision)
+			return m_Systems->VerifyCollision(m_Props.VerifySeed) ? 0 : 1;
+
+		// Without a window the only way out is an input source sending a closed event
+		if (m_Props.Headless && m_Props.HeadlessFrames == 0 && !m_Props.InputSource)
+		{
+			std::cout << "Headless: no frame count and no input source, the run would never end" << std::endl;
+			return 1;
+		}
+
 		sf::Clock clock;
+		uint32_t frame = 0;
+		uint32_t steps = 0;
+
+		float timestep = Time::GetFixedTimestep();
 
 		while (m_Running)
 		{
-			auto time = clock.getElapsedTime().asSeconds();
-			m_Timestep = Time::CalculateDeltaTime(time);
+			EERO_PROFILE_SCOPE("Frame");
+
+			if constexpr (AllocationTracker::Enabled)
+				AllocationTracker::BeginFrame();
+
+			// Headless frames advance exactly one step, back to back
+			if (m_Props.Headless)
+				m_Timestep = timestep;
+			else
+				m_Timestep = Time::CalculateDeltaTime(clock.getElapsedTime().asSeconds());
+
+			m_Accumulator += m_Timestep;
+
+			if (m_Props.InputSource)
+				m_Props.InputSource(frame, *m_Events);
 
 			m_Events->Listen();
-			m_Input->SetEventList(m_Events->GetEvents());
+			m_Input->Ingest(m_Events->GetEvents());
+			m_PendingInputTime = std::min(m_PendingInputTime, m_Events->GetOldestTime());
 
-			for (auto& layer : m_Layers)
+			// Simulation runs in fixed steps whatever the frame rate is, a slow frame
+			// catches up with at most MaxStepsPerFrame steps and drops the rest
+			uint32_t frameSteps = 0;
+			while (m_Accumulator >= timestep && frameSteps < m_Props.MaxStepsPerFrame)
 			{
-				layer->OnUpdate(m_Timestep);
+				EERO_PROFILE_SCOPE("Step");
+
+				m_Systems->BeginStep();
+
+				for (size_t i = 0; i < m_Layers.size(); i++)
+				{
+					EERO_PROFILE_SCOPE(m_LayerZones[i]);
+					m_Layers[i]->OnUpdate(timestep);
+				}
+
+				m_Entities->Update();
+				m_Systems->Run(timestep);
+				m_Input->EndStep();
+
+				m_Accumulator -= timestep;
+				frameSteps++;
 			}
 
-			m_Entities->Update();
+			if (m_Accumulator >= timestep)
+				m_Accumulator = std::fmod(m_Accumulator, timestep);
+
+			steps += frameSteps;
+
+			// The render thread draws the last step while the next ones are simulated
+			if (m_RenderThread && frameSteps > 0)
+			{
+				EERO_PROFILE_SCOPE("WriteSnapshot");
 
-			m_Window->Clear();
-			m_Systems->Run(m_Timestep);
-			m_Window->Display();
+				RenderSnapshot& snapshot = m_RenderThread->GetWriteSnapshot();
+				m_Systems->WriteSnapshot(snapshot);
+
+				snapshot.InputTime = m_PendingInputTime;
+				m_PendingInputTime = RenderSnapshot::NoInput;
+
+				m_RenderThread->PublishSnapshot();
+			}
+			else if (m_Props.Headless && m_Props.HeadlessBatch)
+			{
+				m_Systems->BuildBatch(m_Accumulator / timestep);
+			}
 
 			CheckWindowEvents();
 
+			// Input keeps the state until a step has seen it, the events themselves are done
 			m_Events->Clear();
 
+			if constexpr (AllocationTracker::Enabled)
+				CheckAllocations(frame);
+
+			frame++;
+
+			// Vsync only holds back the render thread, wait for the next step instead of spinning
+			if (!m_Props.Headless && frameSteps == 0)
+				std::this_thread::sleep_for(std::chrono::duration<float>(timestep - m_Accumulator));
+
+			if (m_Props.Headless && m_Props.HeadlessFrames > 0 && frame >= m_Props.HeadlessFrames)
+				m_Running = false;
+		}
+
+		if (m_Props.Headless)
+			PrintThroughput(steps, clock.getElapsedTime().asSeconds());
+
+		return 0;
+	}
+
+	void Application::PrintThroughput(uint32_t steps, float seconds)
+	{
+		std::cout << "Headless: " << steps << " steps in " << seconds << " s, "
+			<< (seconds > 0.0f ? steps / seconds : 0.0f) << " steps/s, "
+			<< m_Entities->GetEntities().size() << " entities at the end" << std::endl;
+
+		if (m_Props.HeadlessBatch)
+		{
+			auto& stats = m_Systems->GetRenderStats();
+			std::cout << "Last batch: " << stats.ShapesDrawn << " shapes drawn, " << stats.ShapesCulled << " culled, "
+				<< stats.ShapesTransparent << " transparent, " << stats.Vertices << " vertices" << std::endl;
+		}
+	}
+
+	void Application::PrintLatency()
+	{
+		LatencyStats latency = m_RenderThread->GetLatency();
+
+		std::cout << "Input to present: " << latency.Samples << " frames with new input, "
+			<< latency.GetAverage() * 1000.0f << " ms average, " << latency.Max * 1000.0f << " ms max" << std::endl;
+	}
+
+	void Application::CheckAllocations(uint32_t frame)
+	{
+		AllocationFrame allocations = AllocationTracker::EndFrame();
+
+		if (m_Props.AllocationBudget == 0 || allocations.Count <= m_Props.AllocationBudget)
+			return;
+
+		m_FramesOverBudget++;
+
+		std::cout << "Frame " << frame << " over the allocation budget: " << allocations.Count << " allocations ("
+			<< allocations.Bytes << " bytes), budget " << m_Props.AllocationBudget << ", most in";
+
+		for (auto& zone : allocations.TopZones)
+		{
+			if (zone.Count > 0)
+				std::cout << " " << (zone.Zone ? zone.Zone : "(no zone)") << " " << zone.Count;
+		}
+
+		std::cout << std::endl;
+	}
+
+	void Application::PrintAllocations()
+	{
+		std::cout << "Allocations: " << AllocationTracker::GetTotalCount() << " (" << AllocationTracker::GetTotalBytes() << " bytes), "
+			<< AllocationTracker::GetPeakBytes() << " bytes peak, " << m_FramesOverBudget << " frames over budget" << std::endl;
+
+		for (auto& zone : AllocationTracker::GetTopZones())
+		{
+			if (zone.Count > 0)
+				std::cout << "  " << zone.Count << " (" << zone.Bytes << " bytes) in " << (zone.Zone ? zone.Zone : "(no zone)") << std::endl;
 		}
 	}
 
 	void Application::CheckWindowEvents()
 	{
-		for (auto& [tag, entityVec] : m_Events->GetEvents())
+		for (auto& e : m_Events->GetEvents())
 		{
-			if (tag == "window")
+			if (e.Type == EventType::WindowClosed)
 			{
-				for (auto& e : entityVec)
-				{
-					if (e->eWindow->Type == "closed")
-					{
-						m_Running = false;
-					}
-					else if (e->eWindow->Type == "resized" && !e->m_Handled)
-					{
-						m_Window->SetSize(e->eWindow->Width, e->eWindow->Height);
-					}
-
-					e->m_Handled = true;
-				}
+				m_Running = false;
+				e.Handled = true;
+			}
+			else if (e.Type == EventType::WindowResized && !e.Handled)
+			{
+				m_Window->SetSize(e.Window.Width, e.Window.Height);
+				e.Handled = true;
 			}
 		}
 	}
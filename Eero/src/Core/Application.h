@@ -2,22 +2,91 @@
 
 #include "Time.h"
 #include "Layer.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 
 #include "Window/Window.h"
 
 #include "ECS/EntityManager.h"
 #include "ECS/Systems.h"
 
+#include "Renderer/RenderThread.h"
+
 #include "Event/EventHandler.h"
 #include "Event/Input.h"
+#include "Event/InputThread.h"
+
+#include <functional>
+#include <cctype>
+#include <cstdlib>
 
 namespace Eero {
 
+	struct CommandLineArgs
+	{
+		int Count = 0;
+		char** Args = nullptr;
+
+		// Index of the argument or -1 when it's not there
+		int Find(const std::string& arg) const
+		{
+			for (int i = 1; i < Count; i++)
+			{
+				if (arg == Args[i])
+					return i;
+			}
+
+			return -1;
+		}
+
+		// Argument at index as an unsigned number, false when it's missing or not a number
+		bool GetNumber(int index, uint32_t& value) const
+		{
+			if (index < 1 || index >= Count || !std::isdigit((unsigned char)Args[index][0]))
+				return false;
+
+			char* end = nullptr;
+			unsigned long number = std::strtoul(Args[index], &end, 10);
+			if (*end != '\0')
+				return false;
+
+			value = (uint32_t)number;
+			return true;
+		}
+
+		const char* operator [] (int index) const { return Args[index]; }
+	};
+
 	struct AppProps
 	{
 		std::string WindowTitle = "Test";
 		float WindowWidth = 1280.0f;
 		float WindowHeight = 720.0f;
+
+		// Simulation rate, rendering interpolates between the last two steps
+		float FixedTimestep = 1.0f / 60.0f;
+		uint32_t MaxStepsPerFrame = 5;
+
+		// Headless runs the simulation without a window or any rendering, one step per frame as fast as it can
+		bool Headless = false;
+		uint32_t HeadlessFrames = 3600; // a minute of steps, 0 = until InputSource pushes a closed event
+		bool HeadlessBatch = false;  // still generate the render batch every frame, for inspecting the vertices
+
+		// Called at the start of every frame to feed events in, mainly for headless runs
+		std::function<void(uint32_t frame, EventHandler& events)> InputSource;
+
+		// Runs the collision mode check instead of the game, Run returns 1 when the modes disagree
+		bool VerifyCollision = false;
+		uint32_t VerifySeed = 1;
+
+		// Print the input-to-present latency at shutdown
+		bool ReportLatency = false;
+
+		// Chrome trace written at shutdown when built with EERO_PROFILE
+		std::string ProfilePath = "EeroProfile.json";
+
+		// Frames allocating more than this get reported when built with EERO_TRACK_ALLOCATIONS, 0 = no budget
+		uint32_t AllocationBudget = 0;
 	};
 
 	class Application
@@ -26,40 +95,65 @@ namespace Eero {
 		Application(const AppProps& props);
 		~Application();
 
-		void Run();
+		// Exit code for main
+		int Run();
 
 		template<typename T>
 		void PushLayer()
 		{
 			static_assert(std::is_base_of<Layer, T>::value, "Pushed type is not subclass of Layer!");
-			m_Layers.emplace_back(std::make_shared<T>())->OnAttach();
+			auto& layer = m_Layers.emplace_back(std::make_shared<T>());
+			m_LayerZones.push_back(Profiler::InternName(layer->GetName()));
+			layer->OnAttach();
 		}
 
 		static std::shared_ptr<EntityManager>& GetEntities() { return s_Entities; }
 		static std::shared_ptr<Input>& GetInput() { return s_Input; }
 		static std::shared_ptr<Window>& GetWindow() { return s_Window; }
 		static std::shared_ptr<Collision>& GetCollision() { return s_Collision; }
+		static std::shared_ptr<JobSystem>& GetJobs() { return s_Jobs; }
+		static std::shared_ptr<Scheduler>& GetScheduler() { return s_Scheduler; }
+		static std::shared_ptr<TweenEngine>& GetTweens() { return s_Tweens; }
+		static std::shared_ptr<ParticleSystem>& GetParticles() { return s_Particles; }
 	private:
 		void Init(const AppProps& props);
 		void Shutdown();
 		void CheckWindowEvents();
+		void PrintThroughput(uint32_t steps, float seconds);
+		void PrintLatency();
+		void CheckAllocations(uint32_t frame);
+		void PrintAllocations();
 	private:
 		std::shared_ptr<Window> m_Window;
 		std::shared_ptr<EventHandler> m_Events;
 		std::shared_ptr<EntityManager> m_Entities;
 		std::shared_ptr<Input> m_Input;
 		std::shared_ptr<Systems> m_Systems;
+		std::shared_ptr<JobSystem> m_Jobs;
+		std::shared_ptr<RenderThread> m_RenderThread;
+		std::shared_ptr<InputThread> m_InputThread;
 		std::vector<std::shared_ptr<Layer>> m_Layers;
+		std::vector<const char*> m_LayerZones; // interned layer names, one per layer
 
 		static std::shared_ptr<EntityManager> s_Entities;
 		static std::shared_ptr<Input> s_Input;
 		static std::shared_ptr<Window> s_Window;
 		static std::shared_ptr<Collision> s_Collision;
+		static std::shared_ptr<JobSystem> s_Jobs;
+		static std::shared_ptr<Scheduler> s_Scheduler;
+		static std::shared_ptr<TweenEngine> s_Tweens;
+		static std::shared_ptr<ParticleSystem> s_Particles;
 
+		AppProps m_Props;
 		bool m_Running = true;
 		float m_Timestep = 0.0f;
+		float m_Accumulator = 0.0f;
+		uint32_t m_FramesOverBudget = 0;
+
+		// Earliest input no published snapshot has shown yet
+		std::chrono::steady_clock::time_point m_PendingInputTime = RenderSnapshot::NoInput;
 	};
 
-	std::shared_ptr<Application> CreateApplication();
+	std::shared_ptr<Application> CreateApplication(const CommandLineArgs& args);
 
 }
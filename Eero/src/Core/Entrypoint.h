@@ -1,9 +1,9 @@
 #pragma once
 
-extern std::shared_ptr<Eero::Application> Eero::CreateApplication();
+extern std::shared_ptr<Eero::Application> Eero::CreateApplication(const Eero::CommandLineArgs& args);
 
 int main(int argc, char** argv)
 {
-	auto app = Eero::CreateApplication();
-	app->Run();
+	auto app = Eero::CreateApplication({ argc, argv });
+	return app->Run();
 }
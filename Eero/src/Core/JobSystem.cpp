@@ -0,0 +1,189 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace Eero {
+
+	static thread_local uint32_t s_WorkerIndex = UINT32_MAX;
+
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		for (uint32_t i = 0; i < workerCount + 1; i++)
+		{
+			m_Queues.push_back(std::make_unique<JobQueue>());
+		}
+
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_Running = false;
+		}
+
+		m_WakeCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	void JobSystem::Run(ParallelForData& data)
+	{
+		size_t chunks = ChunkCount(data.Count, data.GrainSize);
+
+		// Nothing to share, skip the queues entirely
+		if (chunks <= 1 || m_Workers.empty())
+		{
+			if (data.CallerInvoke != nullptr)
+				data.CallerInvoke(data.CallerContext);
+
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				size_t begin = chunk * data.GrainSize;
+				data.Invoke(data.Context, begin, std::min(begin + data.GrainSize, data.Count), chunk);
+			}
+
+			return;
+		}
+
+		data.Remaining = chunks;
+
+		// Counted before pushing so a fast thief never takes the counter below zero
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_QueuedJobs += chunks;
+		}
+
+		// Hand out contiguous runs of chunks to every queue, stealing evens out the rest
+		uint32_t queueCount = (uint32_t)m_Queues.size();
+		for (uint32_t queue = 0; queue < queueCount; queue++)
+		{
+			size_t first = chunks * queue / queueCount;
+			size_t last = chunks * (queue + 1) / queueCount;
+
+			std::lock_guard<std::mutex> lock(m_Queues[queue]->Mutex);
+
+			// Pushed back to front so the owner pops them in ascending order
+			for (size_t chunk = last; chunk > first; chunk--)
+			{
+				m_Queues[queue]->Jobs.push_back({ &data, chunk - 1 });
+			}
+		}
+
+		m_WakeCondition.notify_all();
+
+		if (data.CallerInvoke != nullptr)
+			data.CallerInvoke(data.CallerContext);
+
+		// Help out until every chunk of this call is finished
+		uint32_t index = GetQueueIndex();
+		while (data.Remaining.load(std::memory_order_acquire) > 0)
+		{
+			Job job;
+			if (FindJob(index, job))
+				Execute(job);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WorkerLoop(uint32_t index)
+	{
+		s_WorkerIndex = index;
+
+		while (true)
+		{
+			Job job;
+			if (FindJob(index, job))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_WakeCondition.wait(lock, [this] { return !m_Running || m_QueuedJobs.load() > 0; });
+
+			if (!m_Running)
+				return;
+		}
+	}
+
+	bool JobSystem::Pop(uint32_t index, Job& job)
+	{
+		auto& queue = *m_Queues[index];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		if (queue.Head == queue.Jobs.size())
+			return false;
+
+		job = queue.Jobs.back();
+		queue.Jobs.pop_back();
+
+		if (queue.Head == queue.Jobs.size())
+		{
+			queue.Jobs.clear();
+			queue.Head = 0;
+		}
+
+		m_QueuedJobs--;
+		return true;
+	}
+
+	bool JobSystem::Steal(uint32_t index, Job& job)
+	{
+		uint32_t queueCount = (uint32_t)m_Queues.size();
+
+		for (uint32_t offset = 1; offset < queueCount; offset++)
+		{
+			auto& queue = *m_Queues[(index + offset) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+
+			if (queue.Head == queue.Jobs.size())
+				continue;
+
+			job = queue.Jobs[queue.Head++];
+
+			if (queue.Head == queue.Jobs.size())
+			{
+				queue.Jobs.clear();
+				queue.Head = 0;
+			}
+
+			m_QueuedJobs--;
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::Execute(const Job& job)
+	{
+		ParallelForData& data = *job.Data;
+
+		size_t begin = job.Chunk * data.GrainSize;
+		size_t end = std::min(begin + data.GrainSize, data.Count);
+		data.Invoke(data.Context, begin, end, job.Chunk);
+
+		data.Remaining.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	uint32_t JobSystem::GetQueueIndex() const
+	{
+		// Workers use their own queue, every other thread shares the last one
+		return s_WorkerIndex < m_Workers.size() ? s_WorkerIndex : (uint32_t)m_Workers.size();
+	}
+
+}
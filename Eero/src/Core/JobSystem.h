@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// Thread pool where every thread owns a job queue and steals from the
+	// others once its own queue runs dry. The thread calling ParallelFor works
+	// on the jobs too, so a pool with zero workers simply runs everything inline.
+	class JobSystem
+	{
+	public:
+		// 0 workers = one less than the hardware threads, the caller is the last one
+		JobSystem(uint32_t workerCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator = (const JobSystem&) = delete;
+
+		// Splits [0, count) into chunks of grainSize and calls func(begin, end, chunk)
+		// for every chunk, blocking until all of them are done. Chunk boundaries only
+		// depend on count and grainSize, never on the thread count, so per-chunk
+		// results merged in chunk order are deterministic.
+		template<typename Func>
+		void ParallelFor(size_t count, size_t grainSize, Func func)
+		{
+			if (count == 0)
+				return;
+
+			ParallelForData data;
+			data.Count = count;
+			data.GrainSize = grainSize > 0 ? grainSize : 1;
+			data.Context = &func;
+			data.Invoke = [](void* context, size_t begin, size_t end, size_t chunk)
+			{
+				(*static_cast<Func*>(context))(begin, end, chunk);
+			};
+
+			Run(data);
+		}
+
+		// Same as above, callerFunc runs on the calling thread right after the chunks
+		// are queued, for work that has to stay on this thread (like drawing)
+		template<typename Func, typename CallerFunc>
+		void ParallelFor(size_t count, size_t grainSize, Func func, CallerFunc callerFunc)
+		{
+			ParallelForData data;
+			data.Count = count;
+			data.GrainSize = grainSize > 0 ? grainSize : 1;
+			data.Context = &func;
+			data.Invoke = [](void* context, size_t begin, size_t end, size_t chunk)
+			{
+				(*static_cast<Func*>(context))(begin, end, chunk);
+			};
+			data.CallerContext = &callerFunc;
+			data.CallerInvoke = [](void* context)
+			{
+				(*static_cast<CallerFunc*>(context))();
+			};
+
+			Run(data);
+		}
+
+		static size_t ChunkCount(size_t count, size_t grainSize) { return (count + grainSize - 1) / grainSize; }
+
+		uint32_t GetThreadCount() const { return (uint32_t)m_Workers.size() + 1; }
+	private:
+		struct ParallelForData
+		{
+			size_t Count = 0;
+			size_t GrainSize = 1;
+			void* Context = nullptr;
+			void (*Invoke)(void* context, size_t begin, size_t end, size_t chunk) = nullptr;
+			void* CallerContext = nullptr;
+			void (*CallerInvoke)(void* context) = nullptr;
+			std::atomic<size_t> Remaining = 0;
+		};
+
+		struct Job
+		{
+			ParallelForData* Data = nullptr;
+			size_t Chunk = 0;
+		};
+
+		struct JobQueue
+		{
+			std::mutex Mutex;
+			std::vector<Job> Jobs;
+			size_t Head = 0; // thieves take from the head, the owner pops from the back
+		};
+
+		void Run(ParallelForData& data);
+		void WorkerLoop(uint32_t index);
+
+		bool Pop(uint32_t index, Job& job);
+		bool Steal(uint32_t index, Job& job);
+		bool FindJob(uint32_t index, Job& job) { return Pop(index, job) || Steal(index, job); }
+		void Execute(const Job& job);
+
+		uint32_t GetQueueIndex() const;
+	private:
+		std::vector<std::thread> m_Workers;
+		std::vector<std::unique_ptr<JobQueue>> m_Queues; // one per worker, the last one for outside callers
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+		std::atomic<size_t> m_QueuedJobs = 0;
+		bool m_Running = true;
+	};
+
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <string>
+
 namespace Eero {
 
 	class Layer
 	{
 	public:
+		Layer(const std::string& name = "Layer")
+			: m_Name(name) {}
 		virtual ~Layer() = default;
 
 		virtual void OnAttach() {}
@@ -12,6 +16,10 @@ namespace Eero {
 
 		virtual void OnUpdate(float deltaTime) {}
 		// ImGui OnUIRender(): void
+
+		const std::string& GetName() const { return m_Name; }
+	protected:
+		std::string m_Name;
 	};
 
 }
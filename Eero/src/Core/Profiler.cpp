@@ -0,0 +1,188 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+namespace Eero {
+
+	std::string Profiler::s_Name, Profiler::s_Filepath;
+	std::chrono::steady_clock::time_point Profiler::s_Start;
+	std::atomic<bool> Profiler::s_Active = false;
+
+	std::mutex Profiler::s_BuffersMutex;
+	std::vector<std::unique_ptr<ProfileBuffer>> Profiler::s_Buffers;
+
+	thread_local ProfileBuffer* Profiler::s_ThreadBuffer = nullptr;
+	thread_local const char* Profiler::s_CurrentZone = nullptr;
+
+	void Profiler::BeginSession(const std::string& name, const std::string& filepath)
+	{
+		s_Name = name;
+		s_Filepath = filepath;
+		s_Start = std::chrono::steady_clock::now();
+		s_Active = true;
+	}
+
+	void Profiler::EndSession()
+	{
+		if (!s_Active)
+			return;
+
+		s_Active = false;
+
+		std::lock_guard<std::mutex> lock(s_BuffersMutex);
+
+		WriteTrace();
+		PrintSummary();
+
+		// Buffers stay registered to their threads for the next session
+		for (auto& buffer : s_Buffers)
+		{
+			buffer->Clear();
+		}
+	}
+
+	void Profiler::Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+	{
+		if (!s_Active.load(std::memory_order_relaxed))
+			return;
+
+		int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - s_Start).count();
+		int64_t endNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - s_Start).count();
+
+		GetThreadBuffer().Push({ name, startNs, endNs });
+	}
+
+	const char* Profiler::InternName(const std::string& name)
+	{
+		// Set nodes never move, the strings stay where they are for good
+		static std::mutex s_NamesMutex;
+		static std::unordered_set<std::string> s_Names;
+
+		std::lock_guard<std::mutex> lock(s_NamesMutex);
+		return s_Names.insert(name).first->c_str();
+	}
+
+	ProfileBuffer& Profiler::GetThreadBuffer()
+	{
+		if (!s_ThreadBuffer)
+		{
+			std::lock_guard<std::mutex> lock(s_BuffersMutex);
+			s_ThreadBuffer = s_Buffers.emplace_back(std::make_unique<ProfileBuffer>((uint32_t)s_Buffers.size())).get();
+		}
+
+		return *s_ThreadBuffer;
+	}
+
+	void Profiler::WriteTrace()
+	{
+		std::ofstream file(s_Filepath);
+		if (!file)
+		{
+			std::cout << "Profiler: couldn't write " << s_Filepath << std::endl;
+			return;
+		}
+
+		auto writeEscaped = [&](const char* text)
+		{
+			for (; *text; text++)
+			{
+				if (*text == '"' || *text == '\\')
+					file << '\\';
+
+				file << *text;
+			}
+		};
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"otherData\":{\"session\":\"";
+		writeEscaped(s_Name.c_str());
+		file << "\"},\"traceEvents\":[";
+
+		bool first = true;
+		for (auto& buffer : s_Buffers)
+		{
+			buffer->ForEach([&](const ProfileEvent& event)
+			{
+				file << (first ? "" : ",") << "{\"name\":\"";
+				writeEscaped(event.Name);
+				file << "\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->GetThread()
+					<< ",\"ts\":" << event.Start / 1000.0 << ",\"dur\":" << (event.End - event.Start) / 1000.0 << "}";
+
+				first = false;
+			});
+		}
+
+		file << "]}" << std::endl;
+	}
+
+	void Profiler::PrintSummary()
+	{
+		// Zones with the same name from every thread together
+		std::map<std::string, std::vector<int64_t>> zones;
+		for (auto& buffer : s_Buffers)
+		{
+			buffer->ForEach([&](const ProfileEvent& event)
+			{
+				zones[event.Name].push_back(event.End - event.Start);
+			});
+		}
+
+		struct ZoneSummary
+		{
+			const std::string* Name;
+			size_t Count;
+			double Total, P50, P95, P99; // milliseconds
+		};
+
+		std::vector<ZoneSummary> summaries;
+		for (auto& [name, durations] : zones)
+		{
+			std::sort(durations.begin(), durations.end());
+
+			// Nearest rank
+			auto percentile = [&](double p)
+			{
+				size_t rank = (size_t)std::ceil(p * durations.size());
+				return durations[std::max<size_t>(rank, 1) - 1] / 1e6;
+			};
+
+			double total = 0.0;
+			for (int64_t duration : durations)
+			{
+				total += duration / 1e6;
+			}
+
+			summaries.push_back({ &name, durations.size(), total, percentile(0.50), percentile(0.95), percentile(0.99) });
+		}
+
+		std::sort(summaries.begin(), summaries.end(), [](const ZoneSummary& x, const ZoneSummary& y) { return x.Total > y.Total; });
+
+		uint64_t dropped = 0;
+		for (auto& buffer : s_Buffers)
+		{
+			dropped += buffer->GetDropped();
+		}
+
+		std::cout << "Profile " << s_Name << " (" << s_Filepath << "), milliseconds:" << std::endl;
+
+		if (dropped > 0)
+			std::cout << "  " << dropped << " oldest zones dropped, only the last " << ProfileBuffer::Capacity << " per thread are kept" << std::endl;
+		std::cout << std::fixed << std::setprecision(3);
+
+		for (auto& summary : summaries)
+		{
+			std::cout << "  " << std::setw(10) << summary.Total << " total  "
+				<< std::setw(8) << summary.P50 << " p50  " << std::setw(8) << summary.P95 << " p95  " << std::setw(8) << summary.P99 << " p99  "
+				<< std::setw(7) << summary.Count << "x  " << *summary.Name << std::endl;
+		}
+
+		std::cout.unsetf(std::ios::floatfield);
+	}
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+namespace Eero {
+
+	struct ProfileEvent
+	{
+		const char* Name; // has to outlive the session, string literals or system names
+		int64_t Start;    // nanoseconds since the session began
+		int64_t End;
+	};
+
+	// Zones recorded by one thread. Only the owning thread writes, into a fixed ring allocated
+	// once, so recording takes no lock and memory stays flat however long the session runs.
+	// Once the ring is full the oldest zones are overwritten, the trace keeps the latest ones.
+	class ProfileBuffer
+	{
+	public:
+		static constexpr uint32_t Capacity = 1 << 16;
+
+		ProfileBuffer(uint32_t thread)
+			: m_Thread(thread), m_Events(Capacity) {}
+
+		void Push(const ProfileEvent& event)
+		{
+			m_Events[m_Pushed % Capacity] = event;
+			m_Pushed++;
+		}
+
+		// Oldest to newest
+		template<typename Func>
+		void ForEach(Func func) const
+		{
+			uint64_t first = m_Pushed > Capacity ? m_Pushed - Capacity : 0;
+
+			for (uint64_t i = first; i < m_Pushed; i++)
+			{
+				func(m_Events[i % Capacity]);
+			}
+		}
+
+		void Clear() { m_Pushed = 0; }
+
+		uint32_t GetThread() const { return m_Thread; }
+		uint64_t GetDropped() const { return m_Pushed > Capacity ? m_Pushed - Capacity : 0; }
+	private:
+		uint32_t m_Thread;
+		std::vector<ProfileEvent> m_Events;
+		uint64_t m_Pushed = 0;
+	};
+
+	// Scoped zone profiler. Every thread records into its own buffer, EndSession writes all of
+	// them as a Chrome trace (chrome://tracing, Perfetto) and prints p50/p95/p99 per zone.
+	// Use the EERO_PROFILE_ macros, they compile to nothing unless EERO_PROFILE is defined
+	// (premake --profile). With only EERO_TRACK_ALLOCATIONS they just name the current zone.
+	class Profiler
+	{
+	public:
+		static void BeginSession(const std::string& name, const std::string& filepath);
+
+		// Call once the other threads have stopped recording
+		static void EndSession();
+
+		static void Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+		// Copy of the name that lives as long as the process, for zones named at runtime.
+		// Zones keep the pointer until EndSession, so names owned by something else can't be used.
+		static const char* InternName(const std::string& name);
+
+		// Innermost zone open on the calling thread, null outside of any zone. Also kept when
+		// only allocations are tracked, the session doesn't have to be running.
+		static const char* GetCurrentZone() { return s_CurrentZone; }
+	private:
+		static ProfileBuffer& GetThreadBuffer();
+
+		static void WriteTrace();
+		static void PrintSummary();
+	private:
+		friend class ProfileScope;
+		friend class ZoneScope;
+
+		static std::string s_Name, s_Filepath;
+		static std::chrono::steady_clock::time_point s_Start;
+		static std::atomic<bool> s_Active;
+
+		// Registration is the only locked part, once per thread
+		static std::mutex s_BuffersMutex;
+		static std::vector<std::unique_ptr<ProfileBuffer>> s_Buffers;
+
+		static thread_local ProfileBuffer* s_ThreadBuffer;
+		static thread_local const char* s_CurrentZone;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name)
+			: m_Name(name), m_Parent(Profiler::s_CurrentZone), m_Start(std::chrono::steady_clock::now())
+		{
+			Profiler::s_CurrentZone = name;
+		}
+
+		~ProfileScope()
+		{
+			Profiler::Record(m_Name, m_Start, std::chrono::steady_clock::now());
+			Profiler::s_CurrentZone = m_Parent;
+		}
+	private:
+		const char* m_Name;
+		const char* m_Parent;
+		std::chrono::steady_clock::time_point m_Start;
+	};
+
+	// Only keeps track of the current zone, no timing or recording. The zone macros use it when
+	// allocations are tracked without the profiler, so allocations still land in their zones.
+	class ZoneScope
+	{
+	public:
+		ZoneScope(const char* name)
+			: m_Parent(Profiler::s_CurrentZone)
+		{
+			Profiler::s_CurrentZone = name;
+		}
+
+		~ZoneScope() { Profiler::s_CurrentZone = m_Parent; }
+	private:
+		const char* m_Parent;
+	};
+
+}
+
+#if defined(EERO_PROFILE) || defined(EERO_TRACK_ALLOCATIONS)
+	#if defined(_MSC_VER)
+		#define EERO_FUNC_SIG __FUNCSIG__
+	#else
+		#define EERO_FUNC_SIG __PRETTY_FUNCTION__
+	#endif
+
+	#define EERO_PROFILE_CONCAT_INNER(a, b) a##b
+	#define EERO_PROFILE_CONCAT(a, b) EERO_PROFILE_CONCAT_INNER(a, b)
+#endif
+
+#ifdef EERO_PROFILE
+	#define EERO_PROFILE_BEGIN_SESSION(name, filepath) ::Eero::Profiler::BeginSession(name, filepath)
+	#define EERO_PROFILE_END_SESSION() ::Eero::Profiler::EndSession()
+	#define EERO_PROFILE_SCOPE(name) ::Eero::ProfileScope EERO_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define EERO_PROFILE_FUNCTION() EERO_PROFILE_SCOPE(EERO_FUNC_SIG)
+#elif defined(EERO_TRACK_ALLOCATIONS)
+	#define EERO_PROFILE_BEGIN_SESSION(name, filepath)
+	#define EERO_PROFILE_END_SESSION()
+	#define EERO_PROFILE_SCOPE(name) ::Eero::ZoneScope EERO_PROFILE_CONCAT(zoneScope, __LINE__)(name)
+	#define EERO_PROFILE_FUNCTION() EERO_PROFILE_SCOPE(EERO_FUNC_SIG)
+#else
+	#define EERO_PROFILE_BEGIN_SESSION(name, filepath)
+	#define EERO_PROFILE_END_SESSION()
+	#define EERO_PROFILE_SCOPE(name)
+	#define EERO_PROFILE_FUNCTION()
+#endif
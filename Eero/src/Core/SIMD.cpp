@@ -0,0 +1,85 @@
+#include "SIMD.h"
+
+#if EERO_SIMD_X86 && defined(_MSC_VER)
+	#include <intrin.h>
+#elif EERO_SIMD_X86
+	#include <cpuid.h>
+#endif
+
+namespace Eero {
+
+	static SIMDLevel DetectLevel()
+	{
+#if EERO_SIMD_X86
+	#if defined(_MSC_VER)
+		int info[4] = {};
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		bool avx2 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+
+		// The OS has to save the YMM registers on context switches as well
+		bool ymmEnabled = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+	#else
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+
+		__get_cpuid(1, &eax, &ebx, &ecx, &edx);
+		bool sse2 = (edx & (1u << 26)) != 0;
+		bool osxsave = (ecx & (1u << 27)) != 0;
+		bool avx = (ecx & (1u << 28)) != 0;
+
+		bool avx2 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuid_count(7, 0, eax, ebx, ecx, edx);
+			avx2 = (ebx & (1u << 5)) != 0;
+		}
+
+		bool ymmEnabled = false;
+		if (osxsave)
+		{
+			unsigned int xcr0Low, xcr0High;
+			__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+			ymmEnabled = (xcr0Low & 0x6) == 0x6;
+		}
+	#endif
+
+		if (avx && avx2 && ymmEnabled)
+			return SIMDLevel::AVX2;
+
+		if (sse2)
+			return SIMDLevel::SSE;
+#endif
+
+		return SIMDLevel::Scalar;
+	}
+
+	SIMDLevel SIMD::GetSupportedLevel()
+	{
+		static const SIMDLevel s_Level = DetectLevel();
+		return s_Level;
+	}
+
+	const char* SIMD::GetName(SIMDLevel level)
+	{
+		switch (level)
+		{
+			case SIMDLevel::Scalar: return "Scalar";
+			case SIMDLevel::SSE:    return "SSE";
+			case SIMDLevel::AVX2:   return "AVX2";
+			default:                return "Unknown";
+		}
+	}
+
+}
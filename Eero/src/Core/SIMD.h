@@ -0,0 +1,34 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define EERO_SIMD_X86 1
+	#include <immintrin.h>
+#else
+	#define EERO_SIMD_X86 0
+#endif
+
+// Lets a single function use AVX2 without compiling the whole project for it
+// (MSVC allows the intrinsics anywhere, GCC and Clang need the target attribute)
+#if EERO_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+	#define EERO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+	#define EERO_TARGET_AVX2
+#endif
+
+namespace Eero {
+
+	enum class SIMDLevel
+	{
+		Scalar = 0, SSE = 1, AVX2 = 2
+	};
+
+	class SIMD
+	{
+	public:
+		// Best instruction set supported by both the CPU and the OS, checked once
+		static SIMDLevel GetSupportedLevel();
+
+		static const char* GetName(SIMDLevel level);
+	};
+
+}
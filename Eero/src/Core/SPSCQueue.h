@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Eero {
+
+	// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	// Head and tail sit on their own cache lines so the two sides don't share one.
+	template<typename T, size_t Capacity>
+	class SPSCQueue
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+	public:
+		// Producer side, false when the queue is full
+		bool TryPush(const T& value)
+		{
+			size_t tail = m_Tail.load(std::memory_order_relaxed);
+			if (tail - m_Head.load(std::memory_order_acquire) == Capacity)
+				return false;
+
+			m_Items[tail & s_Mask] = value;
+			m_Tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side, false when the queue is empty
+		bool TryPop(T& value)
+		{
+			size_t head = m_Head.load(std::memory_order_relaxed);
+			if (head == m_Tail.load(std::memory_order_acquire))
+				return false;
+
+			value = m_Items[head & s_Mask];
+			m_Head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+	private:
+		static constexpr size_t s_Mask = Capacity - 1;
+
+		alignas(64) std::atomic<size_t> m_Head = 0;
+		alignas(64) std::atomic<size_t> m_Tail = 0;
+		std::array<T, Capacity> m_Items;
+	};
+
+}
@@ -1,5 +1,7 @@
 #include "Time.h"
 
+#include <cmath>
+
 namespace Eero {
 
 	std::shared_ptr<Time::DeltaTimeData> Time::s_DeltaTimeData = std::make_shared<DeltaTimeData>();
@@ -14,8 +16,7 @@ namespace Eero {
 
 	int Time::Seconds(float seconds)
 	{
-		int rawFrameRate = seconds / s_DeltaTimeData->DeltaTime;
-		int roundedFrameRate = (((int)rawFrameRate + (5 / 2)) / 5) * 5; // round to nearest 5
-		return roundedFrameRate;
+		// Same number of steps on every machine, independent of the frame rate
+		return (int)std::lround(seconds / s_DeltaTimeData->FixedTimestep);
 	}
 }
\ No newline at end of file
@@ -8,11 +8,16 @@ namespace Eero {
 	public:
 		static float CalculateDeltaTime(float currentFrame);
 
+		// The simulation always advances by the fixed timestep, Seconds gives the number of steps
+		static void SetFixedTimestep(float timestep) { s_DeltaTimeData->FixedTimestep = timestep; }
+		static float GetFixedTimestep() { return s_DeltaTimeData->FixedTimestep; }
+
 		static int Seconds(float seconds);
 	private:
 		struct DeltaTimeData
 		{
 			float DeltaTime, LastFrame;
+			float FixedTimestep = 1.0f / 60.0f;
 		};
 
 		static std::shared_ptr<DeltaTimeData> s_DeltaTimeData;
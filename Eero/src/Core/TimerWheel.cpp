@@ -0,0 +1,111 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+namespace Eero {
+
+	TimerWheel::TimerWheel()
+	{
+		for (auto& level : m_Levels)
+		{
+			level.fill({});
+		}
+	}
+
+	TimerHandle TimerWheel::Schedule(uint64_t delay, uint64_t payload)
+	{
+		uint32_t index;
+		if (!m_FreeNodes.empty())
+		{
+			index = m_FreeNodes.back();
+			m_FreeNodes.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)m_Nodes.size();
+			m_Nodes.emplace_back();
+		}
+
+		uint64_t maxDelay = ((uint64_t)1 << (s_SlotBits * s_LevelCount)) - 1;
+
+		TimerNode& node = m_Nodes[index];
+		node.Expire = m_Time + std::clamp<uint64_t>(delay, 1, maxDelay);
+		node.Payload = payload;
+		node.Cancelled = false;
+
+		Insert(index);
+		m_Pending++;
+
+		return { index, node.Serial };
+	}
+
+	void TimerWheel::Cancel(TimerHandle handle)
+	{
+		if (IsPending(handle))
+			m_Nodes[handle.Node].Cancelled = true;
+	}
+
+	bool TimerWheel::IsPending(TimerHandle handle) const
+	{
+		if (handle.Node >= m_Nodes.size())
+			return false;
+
+		const TimerNode& node = m_Nodes[handle.Node];
+		return node.Serial == handle.Serial && !node.Cancelled;
+	}
+
+	void TimerWheel::Insert(uint32_t index)
+	{
+		TimerNode& node = m_Nodes[index];
+		uint64_t delta = node.Expire - m_Time;
+
+		// Lowest level whose range still covers the delay
+		uint32_t level = 0;
+		while (level + 1 < s_LevelCount && delta >= ((uint64_t)1 << (s_SlotBits * (level + 1))))
+		{
+			level++;
+		}
+
+		Slot& slot = m_Levels[level][(node.Expire >> (s_SlotBits * level)) & s_SlotMask];
+
+		// Appended so timers firing on the same tick keep their scheduling order
+		node.Next = s_Null;
+		if (slot.Tail != s_Null)
+			m_Nodes[slot.Tail].Next = index;
+		else
+			slot.Head = index;
+
+		slot.Tail = index;
+	}
+
+	void TimerWheel::Cascade()
+	{
+		// Every time a level wraps around, the next slot of the level above moves down
+		for (uint32_t level = 1; level < s_LevelCount; level++)
+		{
+			if (((m_Time >> (s_SlotBits * (level - 1))) & s_SlotMask) != 0)
+				break;
+
+			Slot& slot = m_Levels[level][(m_Time >> (s_SlotBits * level)) & s_SlotMask];
+			uint32_t index = slot.Head;
+			slot = {};
+
+			while (index != s_Null)
+			{
+				uint32_t next = m_Nodes[index].Next;
+				Insert(index);
+				index = next;
+			}
+		}
+	}
+
+	void TimerWheel::Free(uint32_t index)
+	{
+		// New serial so old handles stop matching the node once it's reused
+		m_Nodes[index].Serial++;
+		m_Nodes[index].Cancelled = false;
+		m_FreeNodes.push_back(index);
+		m_Pending--;
+	}
+
+}
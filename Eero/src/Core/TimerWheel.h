@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	struct TimerHandle
+	{
+		uint32_t Node = UINT32_MAX;
+		uint32_t Serial = 0;
+	};
+
+	// Hierarchical timer wheel counting in ticks (simulation steps). Level 0 has one slot
+	// per tick, every level above covers 64 slots of the one below and gets cascaded down
+	// as time reaches it, so scheduling and firing are O(1) and a tick only costs the
+	// timers that actually fire. Timers carry a 64 bit payload instead of a callback.
+	class TimerWheel
+	{
+	public:
+		TimerWheel();
+
+		// Fires after delay ticks, at least one
+		TimerHandle Schedule(uint64_t delay, uint64_t payload);
+
+		// Lazy, the node is only freed once the wheel gets to it
+		void Cancel(TimerHandle handle);
+		bool IsPending(TimerHandle handle) const;
+
+		// Advances by ticks and calls func(payload) for every timer that fires, in tick order.
+		// func can schedule and cancel timers.
+		template<typename Func>
+		void Advance(uint64_t ticks, Func func)
+		{
+			for (uint64_t tick = 0; tick < ticks; tick++)
+			{
+				m_Time++;
+				Cascade();
+
+				Slot& slot = m_Levels[0][m_Time & s_SlotMask];
+				uint32_t index = slot.Head;
+				slot = {};
+
+				while (index != s_Null)
+				{
+					TimerNode& node = m_Nodes[index];
+					uint32_t next = node.Next;
+					uint64_t payload = node.Payload;
+					bool cancelled = node.Cancelled;
+
+					Free(index);
+
+					if (!cancelled)
+						func(payload);
+
+					index = next;
+				}
+			}
+		}
+
+		uint64_t GetTime() const { return m_Time; }
+		uint32_t GetPendingCount() const { return m_Pending; }
+	private:
+		static constexpr uint32_t s_Null = UINT32_MAX;
+		static constexpr uint32_t s_SlotBits = 6;
+		static constexpr uint32_t s_SlotCount = 1u << s_SlotBits;
+		static constexpr uint64_t s_SlotMask = s_SlotCount - 1;
+		static constexpr uint32_t s_LevelCount = 4; // 2^24 ticks, longer delays are clamped
+
+		struct TimerNode
+		{
+			uint64_t Expire = 0;
+			uint64_t Payload = 0;
+			uint32_t Serial = 0;
+			uint32_t Next = s_Null;
+			bool Cancelled = false;
+		};
+
+		struct Slot
+		{
+			uint32_t Head = s_Null;
+			uint32_t Tail = s_Null;
+		};
+
+		void Insert(uint32_t index);
+		void Cascade();
+		void Free(uint32_t index);
+	private:
+		uint64_t m_Time = 0;
+		uint32_t m_Pending = 0;
+
+		std::vector<TimerNode> m_Nodes;
+		std::vector<uint32_t> m_FreeNodes;
+		std::array<std::array<Slot, s_SlotCount>, s_LevelCount> m_Levels;
+	};
+
+}
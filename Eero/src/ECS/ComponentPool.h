@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+namespace Eero {
+
+	// Every component type gets its own small id, used to index the pool table
+	inline uint32_t NextComponentTypeID()
+	{
+		static uint32_t s_Counter = 0;
+		return s_Counter++;
+	}
+
+	template<typename T>
+	uint32_t ComponentTypeID()
+	{
+		static const uint32_t s_ID = NextComponentTypeID();
+		return s_ID;
+	}
+
+	class IComponentPool
+	{
+	public:
+		virtual ~IComponentPool() = default;
+
+		virtual bool Has(uint32_t entity) const = 0;
+		virtual void Remove(uint32_t entity) = 0;
+	};
+
+	// Sparse set: components live packed in one array, the sparse array maps
+	// an entity id to its slot in the packed array.
+	template<typename T>
+	class ComponentPool : public IComponentPool
+	{
+	public:
+		template<typename... Args>
+		T& Add(uint32_t entity, Args&&... args)
+		{
+			if (m_TrackAdded)
+				m_Added.push_back(entity);
+
+			if (Has(entity))
+			{
+				T& component = m_Components[m_Sparse[entity]];
+				component = T(std::forward<Args>(args)...);
+				return component;
+			}
+
+			if (entity >= m_Sparse.size())
+				m_Sparse.resize(entity + 1, s_Invalid);
+
+			m_Sparse[entity] = (uint32_t)m_Dense.size();
+			m_Dense.push_back(entity);
+			return m_Components.emplace_back(std::forward<Args>(args)...);
+		}
+
+		virtual bool Has(uint32_t entity) const override
+		{
+			return entity < m_Sparse.size() && m_Sparse[entity] != s_Invalid;
+		}
+
+		// Swap and pop, order of the packed array is not kept
+		virtual void Remove(uint32_t entity) override
+		{
+			if (!Has(entity))
+				return;
+
+			uint32_t slot = m_Sparse[entity];
+			uint32_t last = (uint32_t)m_Dense.size() - 1;
+
+			if (slot != last)
+			{
+				m_Components[slot] = std::move(m_Components[last]);
+				m_Dense[slot] = m_Dense[last];
+				m_Sparse[m_Dense[slot]] = slot;
+			}
+
+			m_Components.pop_back();
+			m_Dense.pop_back();
+			m_Sparse[entity] = s_Invalid;
+		}
+
+		T& Get(uint32_t entity) { return m_Components[m_Sparse[entity]]; }
+
+		// Packed access for systems
+		size_t Size() const { return m_Dense.size(); }
+		uint32_t GetEntity(size_t slot) const { return m_Dense[slot]; }
+		T& GetAt(size_t slot) { return m_Components[slot]; }
+		T* Data() { return m_Components.data(); }
+
+		// Opt-in list of entities that got the component added (or replaced) since
+		// the last ClearAdded, for systems that only react to new components
+		void SetTrackAdded(bool track) { m_TrackAdded = track; }
+		const std::vector<uint32_t>& GetAdded() const { return m_Added; }
+		void ClearAdded() { m_Added.clear(); }
+	private:
+		static constexpr uint32_t s_Invalid = UINT32_MAX;
+
+		bool m_TrackAdded = false;
+		std::vector<uint32_t> m_Added;
+
+		std::vector<uint32_t> m_Sparse;
+		std::vector<uint32_t> m_Dense;
+		std::vector<T> m_Components;
+	};
+
+}
@@ -2,7 +2,11 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <memory>
+#include <cstdint>
+
 #include "Core/Math.h"
+#include "Renderer/GeometryCache.h"
 
 namespace Eero {
 
@@ -12,46 +16,57 @@ namespace Eero {
 		Vec2 Velocity = { 0.0f, 0.0f };
 		float Angle = 0.0f;
 
+		// State at the start of the current step, rendering interpolates from it
+		Vec2 PrevPos = { 0.0f, 0.0f };
+		float PrevAngle = 0.0f;
+
 		TransformComponent(const Vec2& pos, const Vec2& velocity, float angle)
-			: Pos(pos), Velocity(velocity), Angle(angle) {}
+			: Pos(pos), Velocity(velocity), Angle(angle), PrevPos(pos), PrevAngle(angle) {}
 	};
 
 	struct ShapeComponent
 	{
-		sf::CircleShape Circle;
+		float Radius = 0.0f;
+		int Points = 0;
+		float Thickness = 0.0f;
+		float Scale = 1.0f;
+
+		sf::Color FillColor;
+		sf::Color OutlineColor;
+
+		const ShapeMesh* Mesh = nullptr; // shared by every shape with the same radius, points and thickness
 
 		ShapeComponent(float radius, int points, const Vec3& fillColor, const Vec3& outlineColor, float thickness)
-			: Circle(radius, points)
-		{
-			Circle.setFillColor(sf::Color(fillColor.x, fillColor.y, fillColor.z));
-			Circle.setOutlineColor(sf::Color(outlineColor.x, outlineColor.y, outlineColor.z));
-			Circle.setOutlineThickness(thickness);
-			Circle.setOrigin(radius, radius);
-		}
+			: Radius(radius), Points(points), Thickness(thickness),
+			  FillColor(fillColor.x, fillColor.y, fillColor.z), OutlineColor(outlineColor.x, outlineColor.y, outlineColor.z),
+			  Mesh(GeometryCache::Get(radius, points, thickness)) {}
 
-		int GetPointCount()
+		int GetPointCount() const
 		{
-			return Circle.getPointCount();
+			return Points;
 		}
 
-		const Vec3& GetFillColor()
+		Vec3 GetFillColor() const
 		{
-			return { (float)Circle.getFillColor().r, (float)Circle.getFillColor().g, (float)Circle.getFillColor().b };
+			return { (float)FillColor.r, (float)FillColor.g, (float)FillColor.b };
 		}
 
-		const Vec3& GetOutlineColor()
+		Vec3 GetOutlineColor() const
 		{
-			return { (float)Circle.getOutlineColor().r, (float)Circle.getOutlineColor().g, (float)Circle.getOutlineColor().b };
+			return { (float)OutlineColor.r, (float)OutlineColor.g, (float)OutlineColor.b };
 		}
 	};
 
 	struct CollisionComponent
 	{
+		static constexpr uint32_t TagLayer = UINT32_MAX;
+
 		float Radius = 0.0f;
 		bool Handled = false;
+		uint32_t Layer = TagLayer; // collision layer, by default the entity's tag id
 
-		CollisionComponent(float radius)
-			: Radius(radius) {}
+		CollisionComponent(float radius, uint32_t layer = TagLayer)
+			: Radius(radius), Layer(layer) {}
 	};
 
 	struct LifespanComponent
@@ -65,6 +80,11 @@ namespace Eero {
 
 		EffectTypes Effect = EffectTypes::Disappear;
 
+		// Matches the timers scheduled for this component, old timers of a replaced component are ignored.
+		// No timer ever carries the unscheduled serial.
+		static constexpr uint32_t Unscheduled = 0;
+		uint32_t TimerSerial = Unscheduled;
+
 		LifespanComponent(int total, int action, LifespanComponent::EffectTypes effect)
 			: TotalTime(total), ActionTime(action), Effect(effect) {}
 
@@ -73,15 +93,16 @@ namespace Eero {
 	struct TextComponent
 	{
 		sf::Text Text;
-		sf::Font Font;
+		std::shared_ptr<sf::Font> Font; // shared so sf::Text keeps a valid font when the pool moves components
 
 		TextComponent(const std::string& fontPath, const std::string& text, const Vec2& position, const Vec3& color, int size)
 		{
 			// Font
-			Font.loadFromFile(fontPath);
+			Font = std::make_shared<sf::Font>();
+			Font->loadFromFile(fontPath);
 
 			// Text
-			Text.setFont(Font);
+			Text.setFont(*Font);
 			Text.setString(text);
 			Text.setPosition(sf::Vector2(position.x, position.y));
 			Text.setFillColor(sf::Color(color.x, color.y, color.z));
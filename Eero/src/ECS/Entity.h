@@ -2,29 +2,56 @@
 
 #include "Components.h"
 
+#include <cstdint>
+
 namespace Eero {
 
+	class EntityManager;
+
+	// Tags are interned by the EntityManager into small ids, see EntityManager::RegisterTag
+	using TagID = uint32_t;
+	constexpr TagID InvalidTag = UINT32_MAX;
+
+	// Lightweight handle: a slot index plus the generation the slot had when the
+	// entity was created. Once the slot is recycled the generation moves on and
+	// every old handle to it stops being valid.
 	class Entity
 	{
 		friend class EntityManager;
 	public:
-		std::shared_ptr<TransformComponent> cTransform;
-		std::shared_ptr<ShapeComponent> cShape;
-		std::shared_ptr<CollisionComponent> cCollision;
-		std::shared_ptr<LifespanComponent> cLifespan;
-		std::shared_ptr<TextComponent> cText;
-
-		bool IsActive() const { return m_Active; }
-		const std::string& GetTag() const { return m_Tag; }
-		const size_t GetIdentifier() const { return m_ID; }
-		void Destroy() { m_Active = false; }
+		Entity() = default;
+
+		// Components are stored in the EntityManager's packed pools, see EntityManager.h
+		template<typename T, typename... Args>
+		T& AddComponent(Args&&... args);
+
+		template<typename T>
+		T& GetComponent();
+
+		template<typename T>
+		bool HasComponent() const;
+
+		template<typename T>
+		void RemoveComponent();
+
+		bool IsValid() const;  // slot still belongs to this entity
+		bool IsActive() const; // valid and not destroyed
+		TagID GetTagID() const;
+		const std::string& GetTag() const;
+		void Destroy();
+
+		uint32_t GetIndex() const { return m_Index; }
+		uint32_t GetGeneration() const { return m_Generation; }
+
+		bool operator == (const Entity& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation && m_Manager == other.m_Manager; }
+		bool operator != (const Entity& other) const { return !(*this == other); }
 	private:
-		Entity(const size_t id, const std::string& tag) 
-		: m_ID(id), m_Tag(tag) {}
+		Entity(uint32_t index, uint32_t generation, EntityManager* manager)
+			: m_Index(index), m_Generation(generation), m_Manager(manager) {}
 	private:
-		bool m_Active = true;
-		size_t m_ID = 0;
-		std::string m_Tag = "Default";
+		uint32_t m_Index = UINT32_MAX;
+		uint32_t m_Generation = 0;
+		EntityManager* m_Manager = nullptr;
 	};
 
 }
@@ -1,44 +1,131 @@
 #include "EntityManager.h"
 
+#include "Core/Profiler.h"
+
 #include <iostream>
 
 namespace Eero {
 
+	const std::vector<Entity> EntityManager::s_EmptyList;
+
 	void EntityManager::Update()
 	{
+		EERO_PROFILE_FUNCTION();
+
 		for (auto& entity : m_EntitiesToAdd)
 		{
+			auto& slot = m_Slots[entity.GetIndex()];
+			auto& tagList = m_TagLists[slot.Tag];
+
+			slot.ListPosition = (uint32_t)m_Entities.size();
+			slot.TagPosition = (uint32_t)tagList.size();
+
 			m_Entities.push_back(entity);
-			m_EntityMap[entity->GetTag()].push_back(entity);
+			tagList.push_back(entity);
 		}
 
 		m_EntitiesToAdd.clear();
 
-		RemoveDeadEntities(m_Entities);
-
-		for (auto& [tag, entityVec] : m_EntityMap)
+		// Only the entities destroyed since the last update are touched
+		for (auto& entity : m_EntitiesToKill)
 		{
-			RemoveDeadEntities(entityVec);
+			auto& slot = m_Slots[entity.GetIndex()];
+
+			RemoveFromList(m_Entities, slot.ListPosition, false);
+			RemoveFromList(m_TagLists[slot.Tag], slot.TagPosition, true);
+
+			ReleaseEntity(entity.GetIndex());
 		}
+
+		m_EntitiesToKill.clear();
 	}
 
-	std::shared_ptr<Entity> EntityManager::PushEntity(const std::string& tag)
+	Entity EntityManager::PushEntity(TagID tag)
 	{
-		auto entity = std::shared_ptr<Entity>(new Entity(m_TotalEntities++, tag));
+		uint32_t index;
+
+		// Reuse a slot of a destroyed entity if there is one
+		if (!m_FreeSlots.empty())
+		{
+			index = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)m_Slots.size();
+			m_Slots.emplace_back();
+		}
+
+		auto& slot = m_Slots[index];
+		slot.Alive = true;
+		slot.Active = true;
+		slot.Tag = tag;
 
+		Entity entity(index, slot.Generation, this);
 		m_EntitiesToAdd.push_back(entity);
 
 		return entity;
 	}
 
-	void EntityManager::RemoveDeadEntities(std::vector<std::shared_ptr<Entity>>& eVec)
+	TagID EntityManager::RegisterTag(const std::string& tag)
 	{
-		for (auto& entity : eVec)
+		auto [it, inserted] = m_TagIDs.try_emplace(tag, (TagID)m_TagNames.size());
+
+		if (inserted)
 		{
-			std::erase_if(eVec, [](auto entity)
-			{
-				return !entity->IsActive();
-			});
+			m_TagNames.push_back(tag);
+			m_TagLists.emplace_back();
+		}
+
+		return it->second;
+	}
+
+	TagID EntityManager::FindTag(const std::string& tag) const
+	{
+		auto it = m_TagIDs.find(tag);
+		return it != m_TagIDs.end() ? it->second : InvalidTag;
+	}
+
+	void EntityManager::Destroy(const Entity& entity)
+	{
+		if (IsActive(entity))
+		{
+			m_Slots[entity.m_Index].Active = false;
+			m_EntitiesToKill.push_back(entity);
+		}
+	}
+
+	void EntityManager::ReleaseEntity(uint32_t index)
+	{
+		for (auto& pool : m_Pools)
+		{
+			if (pool != nullptr)
+				pool->Remove(index);
+		}
+
+		// Bumping the generation invalidates every handle still pointing here
+		auto& slot = m_Slots[index];
+		slot.Alive = false;
+		slot.Generation++;
+
+		m_FreeSlots.push_back(index);
+	}
+
+	void EntityManager::RemoveFromList(std::vector<Entity>& eVec, uint32_t position, bool tagList)
+	{
+		// Swap and pop, the moved entity gets its stored position fixed up
+		Entity last = eVec.back();
+		eVec[position] = last;
+		eVec.pop_back();
+
+		if (position < eVec.size())
+		{
+			auto& slot = m_Slots[last.GetIndex()];
+
+			if (tagList)
+				slot.TagPosition = position;
+			else
+				slot.ListPosition = position;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Entity.h"
+#include "ComponentPool.h"
+
+#include <cassert>
+#include <unordered_map>
 
 namespace Eero {
 
@@ -9,18 +13,128 @@ namespace Eero {
 	public:
 		void Update();
 
-		std::shared_ptr<Entity> PushEntity(const std::string& tag);
+		Entity PushEntity(TagID tag);
+		Entity PushEntity(const std::string& tag) { return PushEntity(RegisterTag(tag)); }
+
+		// Returns the id of the tag, interning it on first use
+		TagID RegisterTag(const std::string& tag);
+		// Lookup only, InvalidTag when the tag has never been registered
+		TagID FindTag(const std::string& tag) const;
+		const std::string& GetTagName(TagID tag) const { return m_TagNames[tag]; }
+
+		const std::vector<Entity>& GetEntities() const { return m_Entities; }
+		const std::vector<Entity>& GetEntities(TagID tag) const { return tag < m_TagLists.size() ? m_TagLists[tag] : s_EmptyList; }
+		const std::vector<Entity>& GetEntities(const std::string& tag) const { return GetEntities(FindTag(tag)); }
+
+		// Handle for whatever currently lives in the slot
+		Entity GetEntity(uint32_t index) { return Entity(index, m_Slots[index].Generation, this); }
+
+		bool IsValid(const Entity& entity) const
+		{
+			return entity.m_Index < m_Slots.size() && m_Slots[entity.m_Index].Alive && m_Slots[entity.m_Index].Generation == entity.m_Generation;
+		}
+
+		bool IsActive(const Entity& entity) const { return IsValid(entity) && m_Slots[entity.m_Index].Active; }
+		TagID GetTagID(const Entity& entity) const { return m_Slots[entity.m_Index].Tag; }
+		void Destroy(const Entity& entity);
+
+		template<typename T>
+		ComponentPool<T>& GetPool()
+		{
+			uint32_t type = ComponentTypeID<T>();
 
-		std::vector<std::shared_ptr<Entity>>& GetEntities() { return m_Entities; }
-		std::vector<std::shared_ptr<Entity>>& GetEntities(const std::string& tag) { return m_EntityMap[tag]; }
+			if (type >= m_Pools.size())
+				m_Pools.resize(type + 1);
+
+			if (m_Pools[type] == nullptr)
+				m_Pools[type] = std::make_shared<ComponentPool<T>>();
+
+			return *static_cast<ComponentPool<T>*>(m_Pools[type].get());
+		}
+
+		// Streams through the packed pool of T and calls func(entity, T&, Others&...)
+		// for every entity that also has all of the Others
+		template<typename T, typename... Others, typename Func>
+		void Each(Func func)
+		{
+			EachImpl<T>(func, GetPool<T>(), GetPool<Others>()...);
+		}
 	private:
-		void RemoveDeadEntities(std::vector<std::shared_ptr<Entity>>& eVec);
+		template<typename T, typename Func, typename... Pools>
+		void EachImpl(Func& func, ComponentPool<T>& pool, Pools&... others)
+		{
+			for (size_t slot = 0; slot < pool.Size(); slot++)
+			{
+				uint32_t index = pool.GetEntity(slot);
+
+				if ((others.Has(index) && ...))
+					func(Entity(index, m_Slots[index].Generation, this), pool.GetAt(slot), others.Get(index)...);
+			}
+		}
+
+		void ReleaseEntity(uint32_t index);
+		void RemoveFromList(std::vector<Entity>& eVec, uint32_t position, bool tagList);
 	private:
-		std::vector<std::shared_ptr<Entity>> m_Entities;
-		std::vector<std::shared_ptr<Entity>> m_EntitiesToAdd;
-		std::map<std::string, std::vector<std::shared_ptr<Entity>>> m_EntityMap;
+		struct EntitySlot
+		{
+			uint32_t Generation = 0;
+			bool Alive = false;  // slot is in use
+			bool Active = false; // not destroyed yet
+			TagID Tag = InvalidTag;
+
+			// Where the entity sits in m_Entities and in its tag list, for O(1) removal
+			uint32_t ListPosition = 0;
+			uint32_t TagPosition = 0;
+		};
 
-		size_t m_TotalEntities = 0;
+		std::vector<Entity> m_Entities;
+		std::vector<Entity> m_EntitiesToAdd;
+		std::vector<Entity> m_EntitiesToKill;
+
+		// Interned tags, each with its own list of entities indexed by TagID
+		std::unordered_map<std::string, TagID> m_TagIDs;
+		std::vector<std::string> m_TagNames;
+		std::vector<std::vector<Entity>> m_TagLists;
+		static const std::vector<Entity> s_EmptyList;
+
+		std::vector<std::shared_ptr<IComponentPool>> m_Pools;
+
+		std::vector<EntitySlot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
 	};
 
+	// Entity helpers, defined here because they need the full EntityManager
+	template<typename T, typename... Args>
+	T& Entity::AddComponent(Args&&... args)
+	{
+		assert(IsValid() && "AddComponent on a stale entity handle!");
+		return m_Manager->GetPool<T>().Add(m_Index, std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	T& Entity::GetComponent()
+	{
+		assert(IsValid() && "GetComponent on a stale entity handle!");
+		return m_Manager->GetPool<T>().Get(m_Index);
+	}
+
+	template<typename T>
+	bool Entity::HasComponent() const
+	{
+		return IsValid() && m_Manager->GetPool<T>().Has(m_Index);
+	}
+
+	template<typename T>
+	void Entity::RemoveComponent()
+	{
+		if (IsValid())
+			m_Manager->GetPool<T>().Remove(m_Index);
+	}
+
+	inline bool Entity::IsValid() const { return m_Manager != nullptr && m_Manager->IsValid(*this); }
+	inline bool Entity::IsActive() const { return m_Manager != nullptr && m_Manager->IsActive(*this); }
+	inline TagID Entity::GetTagID() const { return m_Manager->GetTagID(*this); }
+	inline const std::string& Entity::GetTag() const { return m_Manager->GetTagName(GetTagID()); }
+	inline void Entity::Destroy() { if (m_Manager != nullptr) m_Manager->Destroy(*this); }
+
 }
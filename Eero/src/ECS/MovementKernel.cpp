@@ -0,0 +1,287 @@
+#include "MovementKernel.h"
+
+namespace Eero {
+
+	void MovementKernel::Integrate(SIMDLevel level, float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+		size_t done = 0;
+
+		switch (level)
+		{
+			case SIMDLevel::AVX2:
+			{
+				done = IntegrateAVX2(x, y, velX, velY, radius, count, width, height, deltaTime);
+				break;
+			}
+
+			case SIMDLevel::SSE:
+			{
+				done = IntegrateSSE(x, y, velX, velY, radius, count, width, height, deltaTime);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		IntegrateScalar(x, y, velX, velY, radius, done, count, width, height, deltaTime);
+	}
+
+	void MovementKernel::Integrate(SIMDLevel level, float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+		size_t done = 0;
+
+		switch (level)
+		{
+			case SIMDLevel::AVX2:
+			{
+				done = IntegrateAVX2(state, stride, radius, count, width, height, deltaTime);
+				break;
+			}
+
+			case SIMDLevel::SSE:
+			{
+				done = IntegrateSSE(state, stride, radius, count, width, height, deltaTime);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		IntegrateScalar(state, stride, radius, done, count, width, height, deltaTime);
+	}
+
+	void MovementKernel::IntegrateScalar(float* x, float* y, float* velX, float* velY, const float* radius, size_t begin, size_t count, float width, float height, float deltaTime)
+	{
+		for (size_t i = begin; i < count; i++)
+		{
+			if ((width - x[i]) <= radius[i] || x[i] <= radius[i])
+			{
+				velX[i] *= -1.0f;
+			}
+			else if ((height - y[i]) <= radius[i] || y[i] <= radius[i])
+			{
+				velY[i] *= -1.0f;
+			}
+
+			x[i] += (velX[i] * deltaTime);
+			y[i] += (velY[i] * deltaTime);
+		}
+	}
+
+	size_t MovementKernel::IntegrateSSE(float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+#if EERO_SIMD_X86
+		size_t blocks = count & ~(size_t)3;
+
+		__m128 widthV = _mm_set1_ps(width);
+		__m128 heightV = _mm_set1_ps(height);
+		__m128 deltaV = _mm_set1_ps(deltaTime);
+		__m128 signBit = _mm_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < blocks; i += 4)
+		{
+			__m128 posX = _mm_loadu_ps(&x[i]);
+			__m128 posY = _mm_loadu_ps(&y[i]);
+			__m128 vx = _mm_loadu_ps(&velX[i]);
+			__m128 vy = _mm_loadu_ps(&velY[i]);
+			__m128 r = _mm_loadu_ps(&radius[i]);
+
+			__m128 bounceX = _mm_or_ps(_mm_cmple_ps(_mm_sub_ps(widthV, posX), r), _mm_cmple_ps(posX, r));
+			__m128 bounceY = _mm_or_ps(_mm_cmple_ps(_mm_sub_ps(heightV, posY), r), _mm_cmple_ps(posY, r));
+			bounceY = _mm_andnot_ps(bounceX, bounceY);
+
+			// Flipping the sign bit is the same as multiplying by -1
+			vx = _mm_xor_ps(vx, _mm_and_ps(bounceX, signBit));
+			vy = _mm_xor_ps(vy, _mm_and_ps(bounceY, signBit));
+
+			_mm_storeu_ps(&velX[i], vx);
+			_mm_storeu_ps(&velY[i], vy);
+			_mm_storeu_ps(&x[i], _mm_add_ps(posX, _mm_mul_ps(vx, deltaV)));
+			_mm_storeu_ps(&y[i], _mm_add_ps(posY, _mm_mul_ps(vy, deltaV)));
+		}
+
+		return blocks;
+#else
+		return 0;
+#endif
+	}
+
+	EERO_TARGET_AVX2 size_t MovementKernel::IntegrateAVX2(float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+#if EERO_SIMD_X86
+		size_t blocks = count & ~(size_t)7;
+
+		__m256 widthV = _mm256_set1_ps(width);
+		__m256 heightV = _mm256_set1_ps(height);
+		__m256 deltaV = _mm256_set1_ps(deltaTime);
+		__m256 signBit = _mm256_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < blocks; i += 8)
+		{
+			__m256 posX = _mm256_loadu_ps(&x[i]);
+			__m256 posY = _mm256_loadu_ps(&y[i]);
+			__m256 vx = _mm256_loadu_ps(&velX[i]);
+			__m256 vy = _mm256_loadu_ps(&velY[i]);
+			__m256 r = _mm256_loadu_ps(&radius[i]);
+
+			__m256 bounceX = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(widthV, posX), r, _CMP_LE_OQ), _mm256_cmp_ps(posX, r, _CMP_LE_OQ));
+			__m256 bounceY = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(heightV, posY), r, _CMP_LE_OQ), _mm256_cmp_ps(posY, r, _CMP_LE_OQ));
+			bounceY = _mm256_andnot_ps(bounceX, bounceY);
+
+			vx = _mm256_xor_ps(vx, _mm256_and_ps(bounceX, signBit));
+			vy = _mm256_xor_ps(vy, _mm256_and_ps(bounceY, signBit));
+
+			_mm256_storeu_ps(&velX[i], vx);
+			_mm256_storeu_ps(&velY[i], vy);
+			_mm256_storeu_ps(&x[i], _mm256_add_ps(posX, _mm256_mul_ps(vx, deltaV)));
+			_mm256_storeu_ps(&y[i], _mm256_add_ps(posY, _mm256_mul_ps(vy, deltaV)));
+		}
+
+		return blocks;
+#else
+		return 0;
+#endif
+	}
+
+	// Interleaved versions, the SIMD ones load the first four floats of every entry as a row and
+	// transpose them into lanes. The math is exactly the packed one, results match bit for bit.
+	void MovementKernel::IntegrateScalar(float* state, size_t stride, const float* radius, size_t begin, size_t count, float width, float height, float deltaTime)
+	{
+		for (size_t i = begin; i < count; i++)
+		{
+			float* entry = state + i * stride;
+			float& x = entry[0];
+			float& y = entry[1];
+			float& velX = entry[2];
+			float& velY = entry[3];
+
+			if ((width - x) <= radius[i] || x <= radius[i])
+			{
+				velX *= -1.0f;
+			}
+			else if ((height - y) <= radius[i] || y <= radius[i])
+			{
+				velY *= -1.0f;
+			}
+
+			x += (velX * deltaTime);
+			y += (velY * deltaTime);
+		}
+	}
+
+	size_t MovementKernel::IntegrateSSE(float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+#if EERO_SIMD_X86
+		size_t blocks = count & ~(size_t)3;
+
+		__m128 widthV = _mm_set1_ps(width);
+		__m128 heightV = _mm_set1_ps(height);
+		__m128 deltaV = _mm_set1_ps(deltaTime);
+		__m128 signBit = _mm_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < blocks; i += 4)
+		{
+			float* entry = state + i * stride;
+
+			__m128 posX = _mm_loadu_ps(entry);
+			__m128 posY = _mm_loadu_ps(entry + stride);
+			__m128 vx = _mm_loadu_ps(entry + 2 * stride);
+			__m128 vy = _mm_loadu_ps(entry + 3 * stride);
+			_MM_TRANSPOSE4_PS(posX, posY, vx, vy);
+
+			__m128 r = _mm_loadu_ps(&radius[i]);
+
+			__m128 bounceX = _mm_or_ps(_mm_cmple_ps(_mm_sub_ps(widthV, posX), r), _mm_cmple_ps(posX, r));
+			__m128 bounceY = _mm_or_ps(_mm_cmple_ps(_mm_sub_ps(heightV, posY), r), _mm_cmple_ps(posY, r));
+			bounceY = _mm_andnot_ps(bounceX, bounceY);
+
+			vx = _mm_xor_ps(vx, _mm_and_ps(bounceX, signBit));
+			vy = _mm_xor_ps(vy, _mm_and_ps(bounceY, signBit));
+			posX = _mm_add_ps(posX, _mm_mul_ps(vx, deltaV));
+			posY = _mm_add_ps(posY, _mm_mul_ps(vy, deltaV));
+
+			_MM_TRANSPOSE4_PS(posX, posY, vx, vy);
+			_mm_storeu_ps(entry, posX);
+			_mm_storeu_ps(entry + stride, posY);
+			_mm_storeu_ps(entry + 2 * stride, vx);
+			_mm_storeu_ps(entry + 3 * stride, vy);
+		}
+
+		return blocks;
+#else
+		return 0;
+#endif
+	}
+
+#if EERO_SIMD_X86
+	EERO_TARGET_AVX2 static inline __m256 LoadHalves(const float* low, const float* high)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+	}
+
+	// 4x4 transpose inside each 128-bit half, same steps as _MM_TRANSPOSE4_PS
+	EERO_TARGET_AVX2 static inline void Transpose4x4Halves(__m256& row0, __m256& row1, __m256& row2, __m256& row3)
+	{
+		__m256 low01 = _mm256_unpacklo_ps(row0, row1);
+		__m256 low23 = _mm256_unpacklo_ps(row2, row3);
+		__m256 high01 = _mm256_unpackhi_ps(row0, row1);
+		__m256 high23 = _mm256_unpackhi_ps(row2, row3);
+
+		row0 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0));
+		row1 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2));
+		row2 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0));
+		row3 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+#endif
+
+	EERO_TARGET_AVX2 size_t MovementKernel::IntegrateAVX2(float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime)
+	{
+#if EERO_SIMD_X86
+		size_t blocks = count & ~(size_t)7;
+
+		__m256 widthV = _mm256_set1_ps(width);
+		__m256 heightV = _mm256_set1_ps(height);
+		__m256 deltaV = _mm256_set1_ps(deltaTime);
+		__m256 signBit = _mm256_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < blocks; i += 8)
+		{
+			float* entry = state + i * stride;
+
+			// Entries 0-3 go in the low halves and 4-7 in the high ones, lane k is entry k after the transpose
+			__m256 posX = LoadHalves(entry, entry + 4 * stride);
+			__m256 posY = LoadHalves(entry + stride, entry + 5 * stride);
+			__m256 vx = LoadHalves(entry + 2 * stride, entry + 6 * stride);
+			__m256 vy = LoadHalves(entry + 3 * stride, entry + 7 * stride);
+			Transpose4x4Halves(posX, posY, vx, vy);
+
+			__m256 r = _mm256_loadu_ps(&radius[i]);
+
+			__m256 bounceX = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(widthV, posX), r, _CMP_LE_OQ), _mm256_cmp_ps(posX, r, _CMP_LE_OQ));
+			__m256 bounceY = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(heightV, posY), r, _CMP_LE_OQ), _mm256_cmp_ps(posY, r, _CMP_LE_OQ));
+			bounceY = _mm256_andnot_ps(bounceX, bounceY);
+
+			vx = _mm256_xor_ps(vx, _mm256_and_ps(bounceX, signBit));
+			vy = _mm256_xor_ps(vy, _mm256_and_ps(bounceY, signBit));
+			posX = _mm256_add_ps(posX, _mm256_mul_ps(vx, deltaV));
+			posY = _mm256_add_ps(posY, _mm256_mul_ps(vy, deltaV));
+
+			Transpose4x4Halves(posX, posY, vx, vy);
+
+			__m256 rows[4] = { posX, posY, vx, vy };
+			for (size_t row = 0; row < 4; row++)
+			{
+				_mm_storeu_ps(entry + row * stride, _mm256_castps256_ps128(rows[row]));
+				_mm_storeu_ps(entry + (row + 4) * stride, _mm256_extractf128_ps(rows[row], 1));
+			}
+		}
+
+		return blocks;
+#else
+		return 0;
+#endif
+	}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Core/SIMD.h"
+
+#include <cstddef>
+
+namespace Eero {
+
+	class MovementKernel
+	{
+	public:
+		// Reflects the velocity off the world bounds and integrates the position.
+		// A horizontal bounce wins over a vertical one in the same step, like it always has.
+		static void Integrate(SIMDLevel level, float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime);
+
+		// Same on interleaved state, like a packed component array. Every entry starts with
+		// x, y, velX, velY and the next one is stride floats further, radius stays packed.
+		static void Integrate(SIMDLevel level, float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime);
+	private:
+		static void IntegrateScalar(float* x, float* y, float* velX, float* velY, const float* radius, size_t begin, size_t count, float width, float height, float deltaTime);
+		static size_t IntegrateSSE(float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime);
+		static size_t IntegrateAVX2(float* x, float* y, float* velX, float* velY, const float* radius, size_t count, float width, float height, float deltaTime);
+
+		static void IntegrateScalar(float* state, size_t stride, const float* radius, size_t begin, size_t count, float width, float height, float deltaTime);
+		static size_t IntegrateSSE(float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime);
+		static size_t IntegrateAVX2(float* state, size_t stride, const float* radius, size_t count, float width, float height, float deltaTime);
+	};
+
+}
@@ -0,0 +1,95 @@
+#include "Narrowphase.h"
+
+namespace Eero {
+
+	void Narrowphase::Test(SIMDLevel level, const NarrowphaseBatch& batch, uint8_t* hits)
+	{
+		size_t done = 0;
+
+		// The vector kernels handle whole blocks, the scalar loop picks up the tail
+		switch (level)
+		{
+			case SIMDLevel::AVX2:
+			{
+				done = TestAVX2(batch, hits);
+				break;
+			}
+
+			case SIMDLevel::SSE:
+			{
+				done = TestSSE(batch, hits);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		TestScalar(batch, done, hits);
+	}
+
+	void Narrowphase::TestScalar(const NarrowphaseBatch& batch, size_t begin, uint8_t* hits)
+	{
+		for (size_t i = begin; i < batch.Size(); i++)
+		{
+			hits[i] = Overlaps(batch.XA[i], batch.YA[i], batch.RadiusA[i], batch.XB[i], batch.YB[i], batch.RadiusB[i]) ? 1 : 0;
+		}
+	}
+
+	size_t Narrowphase::TestSSE(const NarrowphaseBatch& batch, uint8_t* hits)
+	{
+#if EERO_SIMD_X86
+		size_t count = batch.Size() & ~(size_t)3;
+
+		for (size_t i = 0; i < count; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch.XB[i]), _mm_loadu_ps(&batch.XA[i]));
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch.YB[i]), _mm_loadu_ps(&batch.YA[i]));
+			__m128 radii = _mm_add_ps(_mm_loadu_ps(&batch.RadiusA[i]), _mm_loadu_ps(&batch.RadiusB[i]));
+
+			__m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			__m128 radiiSq = _mm_mul_ps(radii, radii);
+
+			int mask = _mm_movemask_ps(_mm_cmpgt_ps(radiiSq, distSq));
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				hits[i + lane] = (mask >> lane) & 1;
+			}
+		}
+
+		return count;
+#else
+		return 0;
+#endif
+	}
+
+	EERO_TARGET_AVX2 size_t Narrowphase::TestAVX2(const NarrowphaseBatch& batch, uint8_t* hits)
+	{
+#if EERO_SIMD_X86
+		size_t count = batch.Size() & ~(size_t)7;
+
+		for (size_t i = 0; i < count; i += 8)
+		{
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&batch.XB[i]), _mm256_loadu_ps(&batch.XA[i]));
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&batch.YB[i]), _mm256_loadu_ps(&batch.YA[i]));
+			__m256 radii = _mm256_add_ps(_mm256_loadu_ps(&batch.RadiusA[i]), _mm256_loadu_ps(&batch.RadiusB[i]));
+
+			__m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+			__m256 radiiSq = _mm256_mul_ps(radii, radii);
+
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(radiiSq, distSq, _CMP_GT_OQ));
+
+			for (int lane = 0; lane < 8; lane++)
+			{
+				hits[i + lane] = (mask >> lane) & 1;
+			}
+		}
+
+		return count;
+#else
+		return 0;
+#endif
+	}
+
+}
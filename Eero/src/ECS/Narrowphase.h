@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/SIMD.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// Candidate circle pairs in SoA form, one lane per pair
+	struct NarrowphaseBatch
+	{
+		std::vector<float> XA, YA, RadiusA;
+		std::vector<float> XB, YB, RadiusB;
+
+		void Clear()
+		{
+			XA.clear(); YA.clear(); RadiusA.clear();
+			XB.clear(); YB.clear(); RadiusB.clear();
+		}
+
+		void Push(float xA, float yA, float radiusA, float xB, float yB, float radiusB)
+		{
+			XA.push_back(xA); YA.push_back(yA); RadiusA.push_back(radiusA);
+			XB.push_back(xB); YB.push_back(yB); RadiusB.push_back(radiusB);
+		}
+
+		size_t Size() const { return XA.size(); }
+	};
+
+	class Narrowphase
+	{
+	public:
+		// Reference test, every kernel does exactly these operations in this order
+		// so all of them agree bit for bit
+		static bool Overlaps(float xA, float yA, float radiusA, float xB, float yB, float radiusB)
+		{
+			float dx = xB - xA;
+			float dy = yB - yA;
+			float radii = radiusA + radiusB;
+
+			return (radii * radii) > (dx * dx + dy * dy);
+		}
+
+		// hits[k] is set to 1 when pair k overlaps and 0 otherwise
+		static void Test(SIMDLevel level, const NarrowphaseBatch& batch, uint8_t* hits);
+	private:
+		static void TestScalar(const NarrowphaseBatch& batch, size_t begin, uint8_t* hits);
+		static size_t TestSSE(const NarrowphaseBatch& batch, uint8_t* hits);
+		static size_t TestAVX2(const NarrowphaseBatch& batch, uint8_t* hits);
+	};
+
+}
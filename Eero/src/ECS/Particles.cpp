@@ -0,0 +1,124 @@
+#include "Particles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace Eero {
+
+	ParticleSystem::ParticleSystem(uint32_t capacity)
+		: m_Capacity(capacity)
+	{
+		for (auto* lanes : { &m_X, &m_Y, &m_VelX, &m_VelY, &m_Radius, &m_PrevX, &m_PrevY, &m_Angle, &m_PrevAngle, &m_Spin, &m_Age, &m_Lifetime, &m_FadeTime })
+		{
+			lanes->resize(capacity);
+		}
+
+		m_Meshes.resize(capacity);
+		m_FillColors.resize(capacity);
+		m_OutlineColors.resize(capacity);
+	}
+
+	void ParticleSystem::Emit(const ParticleEmitter& emitter, const Vec2& position)
+	{
+		const ShapeMesh* mesh = GeometryCache::Get(emitter.Radius, emitter.Points, emitter.Thickness);
+		uint32_t count = std::min(emitter.Count, m_Capacity - m_Count);
+
+		// Directions are rotated one step at a time, two trig calls per burst
+		float step = 2.0f * std::numbers::pi_v<float> / (float)std::max(emitter.Count, 1u);
+		float stepCos = std::cos(step), stepSin = std::sin(step);
+		float dirX = stepCos, dirY = stepSin;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t particle = m_Count++;
+
+			m_X[particle] = m_PrevX[particle] = position.x;
+			m_Y[particle] = m_PrevY[particle] = position.y;
+			m_VelX[particle] = emitter.Speed * dirX;
+			m_VelY[particle] = emitter.Speed * dirY;
+			m_Radius[particle] = emitter.Radius;
+			m_Angle[particle] = m_PrevAngle[particle] = 0.0f;
+			m_Spin[particle] = emitter.Spin;
+			m_Age[particle] = 0.0f;
+			m_Lifetime[particle] = emitter.Lifetime;
+			m_FadeTime[particle] = std::min(emitter.FadeTime, emitter.Lifetime);
+			m_Meshes[particle] = mesh;
+			m_FillColors[particle] = emitter.FillColor;
+			m_OutlineColors[particle] = emitter.OutlineColor;
+
+			float nextX = dirX * stepCos - dirY * stepSin;
+			dirY = dirX * stepSin + dirY * stepCos;
+			dirX = nextX;
+		}
+	}
+
+	void ParticleSystem::Update(SIMDLevel level, float width, float height, float deltaTime)
+	{
+		std::copy_n(m_X.begin(), m_Count, m_PrevX.begin());
+		std::copy_n(m_Y.begin(), m_Count, m_PrevY.begin());
+		std::copy_n(m_Angle.begin(), m_Count, m_PrevAngle.begin());
+
+		MovementKernel::Integrate(level, m_X.data(), m_Y.data(), m_VelX.data(), m_VelY.data(), m_Radius.data(), m_Count, width, height, deltaTime);
+
+		for (uint32_t particle = 0; particle < m_Count;)
+		{
+			float age = m_Age[particle] + deltaTime;
+			if (age >= m_Lifetime[particle])
+			{
+				Remove(particle);
+				continue;
+			}
+
+			m_Age[particle] = age;
+			m_Angle[particle] += m_Spin[particle] * deltaTime;
+			particle++;
+		}
+	}
+
+	void ParticleSystem::WriteSnapshot(RenderSnapshot& snapshot) const
+	{
+		for (uint32_t particle = 0; particle < m_Count; particle++)
+		{
+			// Alpha goes from full to 0 over the last FadeTime seconds
+			float remaining = m_Lifetime[particle] - m_Age[particle];
+			float fade = m_FadeTime[particle] > 0.0f ? std::min(remaining / m_FadeTime[particle], 1.0f) : 1.0f;
+
+			sf::Color fill = m_FillColors[particle];
+			sf::Color outline = m_OutlineColors[particle];
+			fill.a = (sf::Uint8)(fill.a * fade);
+			outline.a = (sf::Uint8)(outline.a * fade);
+
+			snapshot.Shapes.push_back({ m_Meshes[particle],
+				m_PrevX[particle], m_PrevY[particle], m_PrevAngle[particle],
+				m_X[particle], m_Y[particle], m_Angle[particle],
+				1.0f, fill, outline });
+		}
+	}
+
+	// Swap and pop, particle order doesn't matter
+	void ParticleSystem::Remove(uint32_t particle)
+	{
+		uint32_t last = --m_Count;
+		if (particle == last)
+			return;
+
+		m_X[particle] = m_X[last];
+		m_Y[particle] = m_Y[last];
+		m_VelX[particle] = m_VelX[last];
+		m_VelY[particle] = m_VelY[last];
+		m_Radius[particle] = m_Radius[last];
+		m_PrevX[particle] = m_PrevX[last];
+		m_PrevY[particle] = m_PrevY[last];
+		m_Angle[particle] = m_Angle[last];
+		m_PrevAngle[particle] = m_PrevAngle[last];
+		m_Spin[particle] = m_Spin[last];
+		m_Age[particle] = m_Age[last];
+		m_Lifetime[particle] = m_Lifetime[last];
+		m_FadeTime[particle] = m_FadeTime[last];
+		m_Meshes[particle] = m_Meshes[last];
+		m_FillColors[particle] = m_FillColors[last];
+		m_OutlineColors[particle] = m_OutlineColors[last];
+	}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "MovementKernel.h"
+
+#include "Core/Math.h"
+#include "Core/SIMD.h"
+#include "Renderer/GeometryCache.h"
+#include "Renderer/RenderSnapshot.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// One burst of particles flying out evenly from a point
+	struct ParticleEmitter
+	{
+		uint32_t Count = 8;
+		float Speed = 300.0f;
+		float Lifetime = 0.6f; // seconds
+		float FadeTime = 0.4f; // linear fade at the end of the lifetime
+		float Spin = 0.0f;     // degrees per second
+
+		float Radius = 16.0f;
+		int Points = 8;
+		float Thickness = 4.0f;
+		sf::Color FillColor;
+		sf::Color OutlineColor;
+	};
+
+	// Short-lived visual particles kept outside the ECS, they have no entity, tag or collider.
+	// The pool is allocated once with a fixed capacity and packed by swap-removal, bursts
+	// beyond the capacity are dropped. Movement uses the same kernel as the entities.
+	class ParticleSystem
+	{
+	public:
+		ParticleSystem(uint32_t capacity = s_DefaultCapacity);
+
+		void Emit(const ParticleEmitter& emitter, const Vec2& position);
+		void Update(SIMDLevel level, float width, float height, float deltaTime);
+		void Clear() { m_Count = 0; }
+
+		// Appends the live particles to the snapshot, drawn in the same batch as the shapes
+		void WriteSnapshot(RenderSnapshot& snapshot) const;
+
+		uint32_t GetCount() const { return m_Count; }
+		uint32_t GetCapacity() const { return m_Capacity; }
+	private:
+		void Remove(uint32_t particle);
+	private:
+		static constexpr uint32_t s_DefaultCapacity = 4096;
+
+		uint32_t m_Count = 0;
+		uint32_t m_Capacity = 0;
+
+		// One lane per particle
+		std::vector<float> m_X, m_Y, m_VelX, m_VelY, m_Radius;
+		std::vector<float> m_PrevX, m_PrevY;
+		std::vector<float> m_Angle, m_PrevAngle, m_Spin;
+		std::vector<float> m_Age, m_Lifetime, m_FadeTime;
+		std::vector<const ShapeMesh*> m_Meshes;
+		std::vector<sf::Color> m_FillColors, m_OutlineColors;
+	};
+
+}
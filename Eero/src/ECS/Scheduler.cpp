@@ -0,0 +1,120 @@
+#include "Scheduler.h"
+
+#include "Core/Profiler.h"
+
+#include <algorithm>
+
+namespace Eero {
+
+	void Scheduler::AddSystem(const std::string& name, ComponentMask reads, ComponentMask writes, const std::function<void(float)>& func, SystemFlags flags)
+	{
+		// Writing implies reading
+		m_Systems.push_back({ name, reads | writes, writes, flags, func, Profiler::InternName(name) });
+		m_Dirty = true;
+	}
+
+	bool Scheduler::Conflicts(const System& a, const System& b)
+	{
+		if (HasFlag(a.Flags, SystemFlags::Exclusive) || HasFlag(b.Flags, SystemFlags::Exclusive))
+			return true;
+
+		if (HasFlag(a.Flags, SystemFlags::Structural) && HasFlag(b.Flags, SystemFlags::Structural))
+			return true;
+
+		return (a.Writes & b.Reads) != 0 || (b.Writes & a.Reads) != 0;
+	}
+
+	void Scheduler::BuildGraph()
+	{
+		uint32_t count = (uint32_t)m_Systems.size();
+		m_Levels.assign(count, 0);
+
+		// Every conflict is an edge from the earlier registration to the later one,
+		// a system sits one level below the deepest system it depends on
+		uint32_t levelCount = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (Conflicts(m_Systems[j], m_Systems[i]))
+					m_Levels[i] = std::max(m_Levels[i], m_Levels[j] + 1);
+			}
+
+			levelCount = std::max(levelCount, m_Levels[i] + 1);
+		}
+
+		// Counting sort by level, registration order is kept inside a level
+		m_LevelStart.assign(levelCount + 1, 0);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			m_LevelStart[m_Levels[i] + 1]++;
+		}
+
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			m_LevelStart[level + 1] += m_LevelStart[level];
+		}
+
+		m_Order.resize(count);
+		std::vector<uint32_t> cursor(m_LevelStart.begin(), m_LevelStart.end() - 1);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			m_Order[cursor[m_Levels[i]]++] = i;
+		}
+
+		m_Dirty = false;
+	}
+
+	const std::vector<uint32_t>& Scheduler::GetLevels()
+	{
+		if (m_Dirty)
+			BuildGraph();
+
+		return m_Levels;
+	}
+
+	void Scheduler::Run(float deltaTime)
+	{
+		if (m_Dirty)
+			BuildGraph();
+
+		for (size_t level = 0; level + 1 < m_LevelStart.size(); level++)
+		{
+			m_Parallel.clear();
+			m_MainThread.clear();
+
+			for (uint32_t k = m_LevelStart[level]; k < m_LevelStart[level + 1]; k++)
+			{
+				uint32_t system = m_Order[k];
+
+				if (HasFlag(m_Systems[system].Flags, SystemFlags::MainThread))
+					m_MainThread.push_back(system);
+				else
+					m_Parallel.push_back(system);
+			}
+
+			// Main thread systems run on this thread while the workers take the rest
+			m_Jobs->ParallelFor(m_Parallel.size(), 1, [&](size_t begin, size_t end, size_t)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					auto& system = m_Systems[m_Parallel[i]];
+
+					EERO_PROFILE_SCOPE(system.ZoneName);
+					system.Func(deltaTime);
+				}
+			},
+			[&]()
+			{
+				for (uint32_t index : m_MainThread)
+				{
+					auto& system = m_Systems[index];
+
+					EERO_PROFILE_SCOPE(system.ZoneName);
+					system.Func(deltaTime);
+				}
+			});
+		}
+	}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "EntityManager.h"
+
+#include "Core/JobSystem.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace Eero {
+
+	// One bit per component type id
+	using ComponentMask = uint64_t;
+
+	template<typename... T>
+	ComponentMask ComponentMaskOf()
+	{
+		assert(((ComponentTypeID<T>() < 64) && ...) && "Too many component types for a ComponentMask!");
+		return (ComponentMask(0) | ... | (ComponentMask(1) << ComponentTypeID<T>()));
+	}
+
+	// Component sets a system declares when it's registered
+	template<typename... T> struct Reads {};
+	template<typename... T> struct Writes {};
+
+	enum class SystemFlags : uint32_t
+	{
+		None = 0,
+		MainThread = 1 << 0, // has to run on the thread that owns the window
+		Structural = 1 << 1, // creates or destroys entities
+		Exclusive = 1 << 2   // can touch anything (user callbacks), runs alone
+	};
+
+	inline SystemFlags operator | (SystemFlags a, SystemFlags b) { return (SystemFlags)((uint32_t)a | (uint32_t)b); }
+	inline bool HasFlag(SystemFlags flags, SystemFlags flag) { return ((uint32_t)flags & (uint32_t)flag) != 0; }
+
+	// Systems are ordered by what they read and write. Two systems conflict when one
+	// writes something the other one touches, conflicting systems run in registration
+	// order and everything else on the same level of the graph runs in parallel.
+	class Scheduler
+	{
+	public:
+		Scheduler(const std::shared_ptr<EntityManager>& entities, const std::shared_ptr<JobSystem>& jobs)
+			: m_EntityManager(entities), m_Jobs(jobs) {}
+
+		template<typename... R, typename... W>
+		void AddSystem(const std::string& name, Reads<R...>, Writes<W...>, const std::function<void(float)>& func, SystemFlags flags = SystemFlags::None)
+		{
+			// Pools are created here so systems never create them at the same time
+			(m_EntityManager->GetPool<R>(), ...);
+			(m_EntityManager->GetPool<W>(), ...);
+
+			AddSystem(name, ComponentMaskOf<R...>(), ComponentMaskOf<W...>(), func, flags);
+		}
+
+		void AddSystem(const std::string& name, ComponentMask reads, ComponentMask writes, const std::function<void(float)>& func, SystemFlags flags = SystemFlags::None);
+
+		void Run(float deltaTime);
+
+		// Graph level of every system, in registration order
+		const std::vector<uint32_t>& GetLevels();
+		const std::string& GetName(uint32_t system) const { return m_Systems[system].Name; }
+		uint32_t GetSystemCount() const { return (uint32_t)m_Systems.size(); }
+	private:
+		struct System
+		{
+			std::string Name;
+			ComponentMask Reads = 0;
+			ComponentMask Writes = 0;
+			SystemFlags Flags = SystemFlags::None;
+			std::function<void(float)> Func;
+			const char* ZoneName = nullptr; // interned, systems move around as the vector grows
+		};
+
+		void BuildGraph();
+		static bool Conflicts(const System& a, const System& b);
+	private:
+		std::shared_ptr<EntityManager> m_EntityManager;
+		std::shared_ptr<JobSystem> m_Jobs;
+
+		std::vector<System> m_Systems;
+		std::vector<uint32_t> m_Levels;
+		std::vector<uint32_t> m_Order;      // systems sorted by level
+		std::vector<uint32_t> m_LevelStart; // prefix sums into m_Order, size = level count + 1
+		std::vector<uint32_t> m_Parallel;   // reused while running a level
+		std::vector<uint32_t> m_MainThread;
+		bool m_Dirty = false;
+	};
+
+}
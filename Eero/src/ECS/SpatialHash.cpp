@@ -0,0 +1,59 @@
+#include "SpatialHash.h"
+
+#include <cmath>
+
+namespace Eero {
+
+	void SpatialHash::Build(const std::vector<float>& posX, const std::vector<float>& posY, float cellSize)
+	{
+		m_Count = (uint32_t)posX.size();
+		m_CellSize = cellSize > 0.0f ? cellSize : 1.0f;
+		m_InvCellSize = 1.0f / m_CellSize;
+
+		// Power of two bucket count, roughly two buckets per entity
+		uint32_t bucketCount = 1;
+		while (bucketCount < m_Count * 2)
+			bucketCount <<= 1;
+
+		m_BucketMask = bucketCount - 1;
+
+		m_CellX.resize(m_Count);
+		m_CellY.resize(m_Count);
+		m_Entries.resize(m_Count);
+		m_BucketStart.assign(bucketCount + 1, 0);
+
+		// Counting sort entities into their buckets
+		for (uint32_t i = 0; i < m_Count; i++)
+		{
+			m_CellX[i] = CellCoord(posX[i]);
+			m_CellY[i] = CellCoord(posY[i]);
+			m_BucketStart[Hash(m_CellX[i], m_CellY[i]) + 1]++;
+		}
+
+		for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+		{
+			m_BucketStart[bucket + 1] += m_BucketStart[bucket];
+		}
+
+		for (uint32_t i = 0; i < m_Count; i++)
+		{
+			uint32_t bucket = Hash(m_CellX[i], m_CellY[i]);
+			uint32_t slot = m_BucketStart[bucket]++;
+			m_Entries[slot] = i;
+		}
+
+		// Filling shifted every start one bucket forward, shift them back
+		for (uint32_t bucket = bucketCount; bucket > 0; bucket--)
+		{
+			m_BucketStart[bucket] = m_BucketStart[bucket - 1];
+		}
+
+		m_BucketStart[0] = 0;
+	}
+
+	int SpatialHash::CellCoord(float value) const
+	{
+		return (int)std::floor(value * m_InvCellSize);
+	}
+
+}
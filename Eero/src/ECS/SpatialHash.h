@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// Uniform grid hashed into a flat bucket table, rebuilt every frame.
+	// Cell size has to be at least the largest collision diameter so that any
+	// overlapping pair always sits in the same or in neighbouring cells.
+	class SpatialHash
+	{
+	public:
+		void Build(const std::vector<float>& posX, const std::vector<float>& posY, float cellSize);
+
+		// Calls func(indexX, indexY) once per candidate pair with indexX < indexY
+		template<typename Func>
+		void ForEachPair(Func func) const
+		{
+			ForEachPair(0, m_Count, func);
+		}
+
+		// Same, limited to pairs whose first entry is in [begin, end) so ranges can run in parallel
+		template<typename Func>
+		void ForEachPair(uint32_t begin, uint32_t end, Func func) const
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				int cellX = m_CellX[i];
+				int cellY = m_CellY[i];
+
+				for (int offsetY = -1; offsetY <= 1; offsetY++)
+				{
+					for (int offsetX = -1; offsetX <= 1; offsetX++)
+					{
+						ForEachInCell(cellX + offsetX, cellY + offsetY, [&](uint32_t j)
+						{
+							if (j > i)
+								func(i, j);
+						});
+					}
+				}
+			}
+		}
+
+		template<typename Func>
+		void ForEachInCell(int cellX, int cellY, Func func) const
+		{
+			uint32_t bucket = Hash(cellX, cellY);
+
+			for (uint32_t k = m_BucketStart[bucket]; k < m_BucketStart[bucket + 1]; k++)
+			{
+				uint32_t index = m_Entries[k];
+
+				// Different cells can share a bucket, only keep the cell that was asked for
+				if (m_CellX[index] == cellX && m_CellY[index] == cellY)
+					func(index);
+			}
+		}
+
+		int CellCoord(float value) const;
+		float GetCellSize() const { return m_CellSize; }
+		uint32_t GetCount() const { return m_Count; }
+	private:
+		uint32_t Hash(int cellX, int cellY) const
+		{
+			uint32_t hash = ((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u);
+			return hash & m_BucketMask;
+		}
+	private:
+		float m_CellSize = 1.0f;
+		float m_InvCellSize = 1.0f;
+		uint32_t m_Count = 0;
+		uint32_t m_BucketMask = 0;
+
+		std::vector<int> m_CellX;
+		std::vector<int> m_CellY;
+		std::vector<uint32_t> m_BucketStart; // prefix sums, size = bucket count + 1
+		std::vector<uint32_t> m_Entries;     // entity indices sorted by bucket
+	};
+
+}
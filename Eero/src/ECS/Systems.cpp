@@ -1,216 +1,646 @@
 #include "Systems.h"
 
 #include "Core/Time.h"
+#include "Core/JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
 
 namespace Eero {
 
 	// Collision
-	void Collision::Listen(std::vector<std::shared_ptr<Entity>>& entities)
+	void Collision::Listen()
+	{
+		m_Colliders.clear();
+		m_ColliderEntities.clear();
+		m_PosX.clear();
+		m_PosY.clear();
+		m_Radius.clear();
+		m_Layers.clear();
+		m_Tags.clear();
+
+		m_EntityManager->Each<CollisionComponent, TransformComponent, ShapeComponent>([&](Entity entity, CollisionComponent& collision, TransformComponent& transform, ShapeComponent&)
+		{
+			uint32_t layer = collision.Layer != CollisionComponent::TagLayer ? collision.Layer : entity.GetTagID();
+			assert((layer < MaxCollisionLayers || collision.Layer == CollisionComponent::TagLayer) && "Collision layer out of range!");
+
+			// Layers that interact with nothing never make it into the broadphase
+			if (layer >= MaxCollisionLayers || m_LayerMasks[layer] == 0)
+				return;
+
+			m_Colliders.push_back(&collision);
+			m_ColliderEntities.push_back(entity);
+			m_PosX.push_back(transform.Pos.x);
+			m_PosY.push_back(transform.Pos.y);
+			m_Radius.push_back(collision.Radius);
+			m_Layers.push_back(layer);
+			m_Tags.push_back(entity.GetTagID());
+		});
+
+		FindContacts();
+
+		for (auto& [indexX, indexY] : m_Contacts)
+		{
+			AddCollision(indexX, indexY);
+		}
+	}
+
+	void Collision::FindContacts()
+	{
+		m_Contacts.clear();
+
+		switch (m_Broadphase)
+		{
+			case BroadphaseMode::BruteForce:
+			{
+				BruteForcePairs();
+				break;
+			}
+
+			case BroadphaseMode::SpatialHash:
+			{
+				SpatialHashPairs();
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		// Handled flags depend on the order pairs are seen in, keep it the same as the reference loop
+		std::sort(m_Contacts.begin(), m_Contacts.end());
+	}
+
+	void Collision::BruteForcePairs()
+	{
+		uint32_t count = (uint32_t)m_PosX.size();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (uint32_t j = i + 1; j < count; j++)
+			{
+				if (!LayersInteract(m_Layers[i], m_Layers[j]))
+					continue;
+
+				if (Narrowphase::Overlaps(m_PosX[i], m_PosY[i], m_Radius[i], m_PosX[j], m_PosY[j], m_Radius[j]))
+				{
+					m_Contacts.emplace_back(i, j);
+				}
+			}
+		}
+	}
+
+	void Collision::SpatialHashPairs()
+	{
+		float maxRadius = 0.0f;
+		for (float radius : m_Radius)
+		{
+			maxRadius = std::max(maxRadius, radius);
+		}
+
+		m_SpatialHash.Build(m_PosX, m_PosY, maxRadius * 2.0f);
+
+		size_t count = m_SpatialHash.GetCount();
+		size_t chunks = JobSystem::ChunkCount(count, s_BroadphaseGrain);
+
+		if (m_Chunks.size() < chunks)
+			m_Chunks.resize(chunks);
+
+		m_Jobs->ParallelFor(count, s_BroadphaseGrain, [&](size_t begin, size_t end, size_t chunkIndex)
+		{
+			auto& chunk = m_Chunks[chunkIndex];
+			chunk.Candidates.clear();
+			chunk.Batch.Clear();
+			chunk.Contacts.clear();
+
+			m_SpatialHash.ForEachPair((uint32_t)begin, (uint32_t)end, [&](uint32_t i, uint32_t j)
+			{
+				if (!LayersInteract(m_Layers[i], m_Layers[j]))
+					return;
+
+				chunk.Candidates.emplace_back(i, j);
+				chunk.Batch.Push(m_PosX[i], m_PosY[i], m_Radius[i], m_PosX[j], m_PosY[j], m_Radius[j]);
+			});
+
+			chunk.Hits.resize(chunk.Candidates.size());
+			Narrowphase::Test(m_Narrowphase, chunk.Batch, chunk.Hits.data());
+
+#ifdef DEBUG
+			// Every kernel has to agree with the scalar reference bit for bit
+			if (m_Narrowphase != SIMDLevel::Scalar)
+			{
+				for (size_t k = 0; k < chunk.Candidates.size(); k++)
+				{
+					auto [i, j] = chunk.Candidates[k];
+					bool reference = Narrowphase::Overlaps(m_PosX[i], m_PosY[i], m_Radius[i], m_PosX[j], m_PosY[j], m_Radius[j]);
+					assert(reference == (chunk.Hits[k] != 0) && "SIMD narrowphase disagrees with the scalar reference!");
+				}
+			}
+#endif
+
+			for (size_t k = 0; k < chunk.Candidates.size(); k++)
+			{
+				if (chunk.Hits[k])
+					chunk.Contacts.push_back(chunk.Candidates[k]);
+			}
+		});
+
+		// Merged in chunk order, the result does not depend on the thread count
+		for (size_t chunkIndex = 0; chunkIndex < chunks; chunkIndex++)
+		{
+			auto& contacts = m_Chunks[chunkIndex].Contacts;
+			m_Contacts.insert(m_Contacts.end(), contacts.begin(), contacts.end());
+		}
+	}
+
+	const std::vector<std::pair<uint32_t, uint32_t>>& Collision::FindContacts(const std::vector<float>& posX, const std::vector<float>& posY, const std::vector<float>& radius, const std::vector<uint32_t>& layers)
 	{
-		for (auto& entityX : entities)
+		m_PosX = posX;
+		m_PosY = posY;
+		m_Radius = radius;
+		m_Layers = layers;
+
+		FindContacts();
+		return m_Contacts;
+	}
+
+	void Collision::SetNarrowphase(SIMDLevel level)
+	{
+		m_Narrowphase = std::min(level, SIMD::GetSupportedLevel());
+	}
+
+	void Collision::AddCollision(uint32_t indexX, uint32_t indexY)
+	{
+		auto& collisionHandledX = m_Colliders[indexX]->Handled;
+		auto& collisionHandledY = m_Colliders[indexY]->Handled;
+
+		if (!(collisionHandledX == true && collisionHandledY == true))
 		{
-			for (auto& entityY : entities)
+			// File the pair straight into the bucket of its (tagX, tagY) handler
+			TagID tagX = m_Tags[indexX];
+			TagID tagY = m_Tags[indexY];
+
+			if (tagX < m_HandlerTableSize && tagY < m_HandlerTableSize)
 			{
-				if (entityX != entityY)
+				uint32_t entry = m_HandlerTable[tagX * m_HandlerTableSize + tagY];
+
+				if (entry != s_NoHandler)
 				{
-					if ((entityX->cShape != nullptr && entityX->cTransform != nullptr && entityX->cCollision != nullptr) && (entityY->cShape != nullptr && entityY->cTransform != nullptr && entityY->cCollision != nullptr))
-					{
-						Vec2 entityXPos = entityX->cTransform->Pos;
-						Vec2 entityYPos = entityY->cTransform->Pos;
-
-						float entityXCollisionRadius = entityX->cCollision->Radius;
-						float entityYCollisionRadius = entityY->cCollision->Radius;
-
-						if ((entityXCollisionRadius + entityYCollisionRadius) > entityXPos.dist(entityYPos))
-						{
-							auto& collisionHandledX = entityX->cCollision->Handled;
-							auto& collisionHandledY = entityY->cCollision->Handled;
-
-							if (!(collisionHandledX == true && collisionHandledY == true))
-							{
-								auto collision = std::make_shared<CollisionData>(entityX, entityY);
-								m_Collisions.push_back(collision);
-
-								collisionHandledX = true;
-								collisionHandledY = true;
-							}
-						}
-					}
+					auto& handler = m_Handlers[entry & ~s_SwappedBit];
+
+					if (entry & s_SwappedBit)
+						handler.Pairs.emplace_back(m_ColliderEntities[indexY], m_ColliderEntities[indexX]);
+					else
+						handler.Pairs.emplace_back(m_ColliderEntities[indexX], m_ColliderEntities[indexY]);
 				}
 			}
+
+			collisionHandledX = true;
+			collisionHandledY = true;
 		}
 	}
 
-	void Collision::CheckCollision(const std::string& tagX, const std::string& tagY, const std::function<void(EntityPairs)>& func)
+	void Collision::Dispatch()
 	{
-		for (auto& collision : m_Collisions)
+		for (size_t i = 0; i < m_Handlers.size(); i++)
 		{
-			auto& entityXTag = collision->EntityX->GetTag();
-			auto& entityYTag = collision->EntityY->GetTag();
+			auto& pairs = m_Handlers[i].Pairs;
 
-			if (entityXTag == tagX && entityYTag == tagY)
+			for (auto& [entityX, entityY] : pairs)
 			{
-				func({ collision->EntityX, collision->EntityY });
-				std::erase(m_Collisions, collision);
+				if (entityX.IsValid() && entityY.IsValid())
+					m_Handlers[i].Func({ entityX, entityY });
 			}
-			else if (entityXTag == tagY && entityYTag == tagX)
+
+			pairs.clear();
+		}
+	}
+
+	void Collision::SetLayerInteraction(uint32_t layerX, uint32_t layerY, bool interact)
+	{
+		if (layerX >= MaxCollisionLayers || layerY >= MaxCollisionLayers)
+		{
+			std::cout << "Collision: layers " << layerX << " and " << layerY << " are out of range, only "
+				<< MaxCollisionLayers << " layers exist" << std::endl;
+			assert(false && "Collision layer out of range!");
+			return;
+		}
+
+		if (interact)
+		{
+			m_LayerMasks[layerX] |= (uint64_t)1 << layerY;
+			m_LayerMasks[layerY] |= (uint64_t)1 << layerX;
+		}
+		else
+		{
+			m_LayerMasks[layerX] &= ~((uint64_t)1 << layerY);
+			m_LayerMasks[layerY] &= ~((uint64_t)1 << layerX);
+		}
+	}
+
+	void Collision::OnCollision(TagID tagX, TagID tagY, const std::function<void(EntityPairs)>& func)
+	{
+		// Tags double as the default collision layers, past the last layer the handler would never fire
+		if (tagX >= MaxCollisionLayers || tagY >= MaxCollisionLayers)
+		{
+			std::cout << "Collision: tags " << tagX << " and " << tagY << " have no collision layer, only "
+				<< MaxCollisionLayers << " layers exist, the handler is not registered" << std::endl;
+			assert(false && "OnCollision with a tag past the last collision layer!");
+			return;
+		}
+
+		SetLayerInteraction(tagX, tagY, true);
+
+		uint32_t size = std::max(tagX, tagY) + 1;
+
+		if (size > m_HandlerTableSize)
+		{
+			std::vector<uint32_t> table(size * size, s_NoHandler);
+
+			for (uint32_t x = 0; x < m_HandlerTableSize; x++)
 			{
-				func({ collision->EntityY, collision->EntityX });
-				std::erase(m_Collisions, collision);
+				for (uint32_t y = 0; y < m_HandlerTableSize; y++)
+				{
+					table[x * size + y] = m_HandlerTable[x * m_HandlerTableSize + y];
+				}
 			}
+
+			m_HandlerTable = std::move(table);
+			m_HandlerTableSize = size;
 		}
+
+		uint32_t handler = (uint32_t)m_Handlers.size();
+		m_Handlers.push_back({ tagX, tagY, func, {} });
+
+		m_HandlerTable[tagY * m_HandlerTableSize + tagX] = handler | s_SwappedBit;
+		m_HandlerTable[tagX * m_HandlerTableSize + tagY] = handler;
+	}
+
+	void Collision::OnCollision(const std::string& tagX, const std::string& tagY, const std::function<void(EntityPairs)>& func)
+	{
+		OnCollision(m_EntityManager->RegisterTag(tagX), m_EntityManager->RegisterTag(tagY), func);
 	}
 	
 	// Systems
 	Systems::Systems(const SystemsProps& props)
-		: m_RenderWindow(props.RenderWindow), m_EntityManager(props.EntityManager)
+		: m_Window(props.Window), m_EntityManager(props.EntityManager), m_Jobs(props.Jobs)
 	{
-		m_Collision = std::shared_ptr<Collision>(new Collision);
+		m_Collision = std::shared_ptr<Collision>(new Collision(m_EntityManager, m_Jobs));
+		m_Scheduler = std::make_shared<Scheduler>(m_EntityManager, m_Jobs);
+		m_Tweens = std::make_shared<TweenEngine>(m_EntityManager, m_Jobs);
+		m_Particles = std::make_shared<ParticleSystem>();
+		m_Renderer = std::make_shared<BatchRenderer>();
+
+		// New lifespans get their timers scheduled by the Lifespan system
+		m_EntityManager->GetPool<LifespanComponent>().SetTrackAdded(true);
+
+		m_Scheduler->AddSystem("Movement", Reads<ShapeComponent>(), Writes<TransformComponent>(),
+			[this](float deltaTime) { Movement(deltaTime); });
+
+		m_Scheduler->AddSystem("Lifespan", Reads<>(), Writes<LifespanComponent, ShapeComponent>(),
+			[this](float) { Lifespan(); }, SystemFlags::Structural);
+
+		m_Scheduler->AddSystem("Tweens", Reads<>(), Writes<ShapeComponent>(),
+			[this](float deltaTime) { m_Tweens->Update(deltaTime); });
+
+		// Touches no components, particles are emitted from the exclusive collision handlers
+		m_Scheduler->AddSystem("Particles", Reads<>(), Writes<>(),
+			[this](float deltaTime)
+			{
+				auto [width, height] = m_Window->GetSize();
+				m_Particles->Update(m_SIMDLevel, width, height, deltaTime);
+			});
+
+		m_Scheduler->AddSystem("CollisionListen", Reads<TransformComponent, ShapeComponent>(), Writes<CollisionComponent>(),
+			[this](float) { m_Collision->Listen(); });
+
+		// Handlers are user code, they can touch anything
+		m_Scheduler->AddSystem("CollisionDispatch", Reads<>(), Writes<>(),
+			[this](float) { m_Collision->Dispatch(); }, SystemFlags::MainThread | SystemFlags::Exclusive);
 	}
 
-	void Systems::Run(float deltaTime)
+	void Systems::BeginStep()
 	{
-		m_Entities = m_EntityManager->GetEntities();
+		auto& transforms = m_EntityManager->GetPool<TransformComponent>();
 
-		Render();
-		Movement(deltaTime);
-		Lifespan();
+		for (size_t slot = 0; slot < transforms.Size(); slot++)
+		{
+			auto& transform = transforms.GetAt(slot);
+			transform.PrevPos = transform.Pos;
+			transform.PrevAngle = transform.Angle;
+		}
+	}
 
-		m_Collision->Listen(m_Entities);
+	void Systems::Run(float deltaTime)
+	{
+		m_Scheduler->Run(deltaTime);
 	}
 
-	void Systems::Movement(float deltaTime)
+	bool Systems::VerifyCollision(uint32_t seed)
 	{
-		for (auto& entity : m_Entities)
+		Collision check(m_EntityManager, m_Jobs);
+		std::mt19937 random(seed);
+
+		std::vector<float> posX, posY, radius;
+		std::vector<uint32_t> layers;
+
+		auto push = [&](float x, float y, float r, uint32_t layer)
 		{
-			if (entity->cShape != nullptr && entity->cTransform != nullptr)
-			{
-				float& posX = entity->cTransform->Pos.x;
-				float& posY = entity->cTransform->Pos.y;
-				float& velX = entity->cTransform->Velocity.x;
-				float& velY = entity->cTransform->Velocity.y;
+			posX.push_back(x);
+			posY.push_back(y);
+			radius.push_back(r);
+			layers.push_back(layer);
+		};
+
+		constexpr uint32_t rounds = 72;
+		constexpr uint32_t layerCount = 4;
+
+		// Cell size is twice the largest radius. Only a power of two makes value / cellSize exact,
+		// the others round, which is where cell assignment goes wrong if it's going to.
+		constexpr float cellSizes[] = { 64.0f, 48.0f, 100.0f };
 
-				float radius = entity->cShape->Circle.getRadius();
-				if ((m_RenderWindow->getSize().x - posX) <= radius || (0 + posX) <= radius)
+		// Where the circles go, around the screen, far into negative and far out where a float step is 1/16
+		constexpr float origins[][2] = { { 0.0f, 0.0f }, { -40000.0f, -25000.0f }, { 1000000.0f, 600000.0f } };
+
+		uint32_t failures = 0;
+
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			posX.clear();
+			posY.clear();
+			radius.clear();
+			layers.clear();
+
+			float cellSize = cellSizes[round % 3];
+			float maxRadius = cellSize * 0.5f;
+			float originX = origins[(round / 3) % 3][0];
+			float originY = origins[(round / 3) % 3][1];
+
+			std::uniform_real_distribution<float> x(originX - 64.0f, originX + 1344.0f), y(originY - 64.0f, originY + 784.0f), r(1.0f, maxRadius);
+			std::uniform_int_distribution<uint32_t> layer(0, layerCount - 1), count(0, 1500);
+			std::uniform_int_distribution<int> cellX((int)std::floor(originX / cellSize) - 2, (int)std::floor(originX / cellSize) + 22);
+			std::uniform_int_distribution<int> cellY((int)std::floor(originY / cellSize) - 2, (int)std::floor(originY / cellSize) + 14);
+
+			// Random interaction matrix, self interaction included
+			for (uint32_t layerX = 0; layerX < layerCount; layerX++)
+			{
+				for (uint32_t layerY = layerX; layerY < layerCount; layerY++)
 				{
-					velX *= -1.0f;
+					check.SetLayerInteraction(layerX, layerY, random() % 4 != 0);
 				}
-				else if ((m_RenderWindow->getSize().y - posY) <= radius || (0 + posY) <= radius)
+			}
+
+			push(x(random), y(random), maxRadius, layer(random));
+
+			uint32_t circles = count(random);
+			for (uint32_t i = 0; i < circles; i++)
+			{
+				push(x(random), y(random), r(random), layer(random));
+			}
+
+			// Pairs exactly r1 + r2 apart, axis aligned and along a 3-4-5 triangle. Whole numbers
+			// keep every coordinate and distance exact, even far out.
+			for (uint32_t i = 0; i < 32; i++)
+			{
+				float baseX = std::floor(x(random)), baseY = std::floor(y(random));
+				float scale = (float)(1 + i % 4);
+				float side = std::floor(r(random));
+
+				push(baseX, baseY, 2.0f * scale, layer(random));
+				push(baseX + 3.0f * scale, baseY + 4.0f * scale, 3.0f * scale, layer(random));
+
+				push(baseX, baseY + 100.0f, side, layer(random));
+				push(baseX + 2.0f * side, baseY + 100.0f, side, layer(random));
+
+				push(baseX + 200.0f, baseY, side, layer(random));
+				push(baseX + 200.0f, baseY + side + maxRadius, maxRadius, layer(random));
+
+				// A hair closer than touching
+				push(baseX, baseY + 200.0f, side, layer(random));
+				push(std::nextafter(baseX + 2.0f * side, -INFINITY), baseY + 200.0f, side, layer(random));
+			}
+
+			// Centers on cell boundaries and just below them, and touching pairs straddling a boundary
+			for (uint32_t i = 0; i < 64; i++)
+			{
+				float edgeX = (float)cellX(random) * cellSize;
+				float edgeY = (float)cellY(random) * cellSize;
+				float side = std::floor(r(random));
+
+				push(edgeX, edgeY, r(random), layer(random));
+				push(std::nextafter(edgeX, -INFINITY), edgeY, r(random), layer(random));
+				push(edgeX, std::nextafter(edgeY, -INFINITY), r(random), layer(random));
+				push(edgeX + cellSize - r(random), edgeY, maxRadius, layer(random));
+
+				push(edgeX - side, edgeY + 0.5f * cellSize, side, layer(random));
+				push(edgeX + side, edgeY + 0.5f * cellSize, side, layer(random));
+				push(edgeX + 0.5f * cellSize, edgeY - maxRadius, maxRadius, layer(random));
+				push(edgeX + 0.5f * cellSize, edgeY + maxRadius, maxRadius, layer(random));
+			}
+
+			check.SetBroadphase(BroadphaseMode::BruteForce);
+			check.SetNarrowphase(SIMDLevel::Scalar);
+			std::vector<std::pair<uint32_t, uint32_t>> reference = check.FindContacts(posX, posY, radius, layers);
+
+			check.SetBroadphase(BroadphaseMode::SpatialHash);
+
+			for (int level = (int)SIMDLevel::Scalar; level <= (int)SIMD::GetSupportedLevel(); level++)
+			{
+				check.SetNarrowphase((SIMDLevel)level);
+				auto& contacts = check.FindContacts(posX, posY, radius, layers);
+
+				if (contacts != reference)
 				{
-					velY *= -1.0f;
+					failures++;
+					std::cout << "Collision check: round " << round << ", cell size " << cellSize << ", " << posX.size() << " circles, spatial hash + "
+						<< SIMD::GetName((SIMDLevel)level) << " found " << contacts.size() << " contacts, brute force + scalar "
+						<< reference.size() << std::endl;
 				}
-
-				posX += (velX * deltaTime);
-				posY += (velY * deltaTime);
 			}
 		}
+
+		std::cout << "Collision check (seed " << seed << "): " << rounds << " rounds, " << (failures == 0 ? "all modes agree" : "MISMATCH") << std::endl;
+		return failures == 0;
 	}
 
-	void Systems::Render()
+	void Systems::Movement(float deltaTime)
 	{
-		for (auto& entity : m_Entities) 
+		// Window size is read once per frame instead of per entity
+		auto [width, height] = m_Window->GetSize();
+		m_WorldWidth = width;
+		m_WorldHeight = height;
+
+		auto& transforms = m_EntityManager->GetPool<TransformComponent>();
+		auto& shapes = m_EntityManager->GetPool<ShapeComponent>();
+
+		size_t chunks = JobSystem::ChunkCount(transforms.Size(), s_MovementGrain);
+		if (m_MovementChunks.size() < chunks)
+			m_MovementChunks.resize(chunks);
+
+		// The kernel works in place on the packed transforms, it reads x, y, velX, velY from the front of each one
+		static_assert(offsetof(TransformComponent, Pos) == 0 && offsetof(TransformComponent, Velocity) == 2 * sizeof(float), "TransformComponent has to start with Pos and Velocity");
+		static_assert(sizeof(TransformComponent) % sizeof(float) == 0, "TransformComponent has to be made of floats");
+		constexpr size_t stride = sizeof(TransformComponent) / sizeof(float);
+
+		// Entities are independent, each chunk integrates its own range. Entities without a shape
+		// don't move, so a chunk goes in runs of transforms that all have one.
+		m_Jobs->ParallelFor(transforms.Size(), s_MovementGrain, [&](size_t begin, size_t end, size_t chunkIndex)
 		{
-			if (entity->cShape != nullptr && entity->cTransform != nullptr)
+			auto& radius = m_MovementChunks[chunkIndex].Radius;
+
+			for (size_t slot = begin; slot < end; slot++)
 			{
-				entity->cShape->Circle.setPosition(entity->cTransform->Pos.x, entity->cTransform->Pos.y);
-				entity->cShape->Circle.setRotation(entity->cTransform->Angle);
+				size_t run = slot;
+				radius.clear();
 
-				m_RenderWindow->draw(entity->cShape->Circle);
+				for (; slot < end && shapes.Has(transforms.GetEntity(slot)); slot++)
+				{
+					radius.push_back(shapes.Get(transforms.GetEntity(slot)).Radius);
+				}
+
+				if (!radius.empty())
+					MovementKernel::Integrate(m_SIMDLevel, reinterpret_cast<float*>(&transforms.GetAt(run)), stride, radius.data(), radius.size(), m_WorldWidth, m_WorldHeight, deltaTime);
 			}
+		});
+	}
 
-			if (entity->cText != nullptr)
+	void Systems::WriteSnapshot(RenderSnapshot& snapshot)
+	{
+		snapshot.Clear();
+
+		m_EntityManager->Each<ShapeComponent, TransformComponent>([&](Entity, ShapeComponent& shape, TransformComponent& transform)
+		{
+			// Fully faded shapes never make it into the snapshot
+			bool outlineVisible = shape.Thickness != 0.0f && shape.OutlineColor.a != 0;
+			if (shape.Mesh == nullptr || (shape.FillColor.a == 0 && !outlineVisible))
 			{
-				m_RenderWindow->draw(entity->cText->Text);
+				snapshot.TransparentShapes++;
+				return;
 			}
-		}
+
+			snapshot.Shapes.push_back({ shape.Mesh,
+				transform.PrevPos.x, transform.PrevPos.y, transform.PrevAngle,
+				transform.Pos.x, transform.Pos.y, transform.Angle,
+				shape.Scale, shape.FillColor, shape.OutlineColor });
+		});
+
+		m_EntityManager->Each<TextComponent>([&](Entity, TextComponent& text)
+		{
+			TextSnapshot& textSnapshot = snapshot.PushText();
+			textSnapshot.Text = text.Text;
+			textSnapshot.Font = text.Font;
+		});
+
+		m_Particles->WriteSnapshot(snapshot);
+
+		snapshot.PublishTime = std::chrono::steady_clock::now();
+	}
+
+	void Systems::BuildBatch(float alpha)
+	{
+		WriteSnapshot(m_Snapshot);
+
+		// No view without a window, the whole window size is visible
+		auto [width, height] = m_Window->GetSize();
+		m_Renderer->Build(m_Snapshot, alpha, { 0.0f, 0.0f, width, height }, m_RenderStats);
 	}
 
 	void Systems::Lifespan()
 	{
-		for (auto& entity : m_Entities)
+		auto& lifespans = m_EntityManager->GetPool<LifespanComponent>();
+		auto& shapes = m_EntityManager->GetPool<ShapeComponent>();
+
+		// Only the timers due this step cost anything, stale ones are skipped by their serial
+		m_LifespanTimers.Advance(1, [&](uint64_t payload)
 		{
-			if (entity->cShape != nullptr && entity->cLifespan != nullptr)
-			{
-				int& totalTime = entity->cLifespan->TotalTime;
-				int actionTime = entity->cLifespan->ActionTime;
+			uint32_t index = (uint32_t)(payload >> 32);
+			uint32_t serial = (uint32_t)(payload & 0xFFFFFFFF) >> 1;
 
-				if (totalTime > 0 && totalTime <= actionTime)
-				{
-					switch (entity->cLifespan->Effect)
-					{
-						case LifespanComponent::EffectTypes::Disappear:
-						{
-							break;
-						}
-
-						case LifespanComponent::EffectTypes::Fade:
-						{
-							// FillColor
-							auto& fillColor = entity->cShape->Circle.getFillColor();
-							int fillAlpha = fillColor.a - (fillColor.a / totalTime);
-
-							// OutlineColor
-							auto& outlineColor = entity->cShape->Circle.getOutlineColor();
-							int outlineAlpha = outlineColor.a - (outlineColor.a / totalTime);
-
-							entity->cShape->Circle.setFillColor(sf::Color(fillColor.r, fillColor.g, fillColor.b, fillAlpha));
-							entity->cShape->Circle.setOutlineColor(sf::Color(outlineColor.r, outlineColor.g, outlineColor.b, outlineAlpha));
-
-							break;
-						}
-
-						case LifespanComponent::EffectTypes::Blink:
-						{
-							int halfTime = Time::Seconds(1) / 2;
-							int modulo = actionTime % halfTime;
-
-							// FillColor
-							auto& fillColor = entity->cShape->Circle.getFillColor();
-							static int originalFillAlpha = fillColor.a;
-							int fillAlpha = fillColor.a;
-
-							// OutlineColor
-							auto& outlineColor = entity->cShape->Circle.getOutlineColor();
-							static int originalOutlineAlpha = outlineColor.a;
-							int outlineAlpha = outlineColor.a;
-
-							// Adjustable with seconds, on every second entity fades out and fades in
-							static int timer = Time::Seconds(1);
-
-							if (timer > halfTime && timer <= timer)
-							{
-								fillAlpha = (originalFillAlpha * (timer - halfTime) / halfTime);
-								outlineAlpha = (originalOutlineAlpha * (timer - halfTime) / halfTime);
-							}
-							else if (timer > 0 && timer <= halfTime)
-							{
-								fillAlpha += originalFillAlpha / halfTime;
-								outlineAlpha += originalOutlineAlpha / halfTime;
-							}
-							else
-							{
-								timer = Time::Seconds(1);
-							}
-							timer--;
-
-							entity->cShape->Circle.setFillColor(sf::Color(fillColor.r, fillColor.g, fillColor.b, fillAlpha));
-							entity->cShape->Circle.setOutlineColor(sf::Color(outlineColor.r, outlineColor.g, outlineColor.b, outlineAlpha));
-
-							break;
-						}
-
-						default:
-							break;
-					}
-				}
+			if (!lifespans.Has(index) || lifespans.Get(index).TimerSerial != serial)
+				return;
 
-				if (totalTime == 0)
-				{
-					entity->Destroy();
-				}
+			if (payload & 1)
+				m_EntityManager->GetEntity(index).Destroy();
+			else
+				StartLifespanEffect(index, lifespans.Get(index));
+		});
+
+		for (uint32_t index : lifespans.GetAdded())
+		{
+			// Lifespans only run on shapes
+			if (lifespans.Has(index) && shapes.Has(index))
+				ScheduleLifespan(index, lifespans.Get(index));
+		}
+
+		lifespans.ClearAdded();
+	}
+
+	void Systems::ScheduleLifespan(uint32_t entity, LifespanComponent& lifespan)
+	{
+		// 31 bits fit in the payload, the counter skips the unscheduled serial when it wraps
+		uint32_t serial = m_LifespanSerial;
+		m_LifespanSerial = (m_LifespanSerial + 1) & 0x7FFFFFFF;
+		if (m_LifespanSerial == LifespanComponent::Unscheduled)
+			m_LifespanSerial++;
+
+		lifespan.TimerSerial = serial;
+
+		uint64_t payload = ((uint64_t)entity << 32) | ((uint64_t)serial << 1);
+		int totalTime = lifespan.TotalTime;
+
+		if (totalTime <= 0)
+		{
+			m_EntityManager->GetEntity(entity).Destroy();
+			return;
+		}
+
+		m_LifespanTimers.Schedule(totalTime, payload | 1);
+
+		if (lifespan.Effect == LifespanComponent::EffectTypes::Disappear || lifespan.ActionTime <= 0)
+			return;
+
+		// The effect runs for the last ActionTime steps
+		int effectStart = std::max(totalTime - lifespan.ActionTime, 0);
 
-				totalTime--;
+		if (effectStart == 0)
+			StartLifespanEffect(entity, lifespan);
+		else
+			m_LifespanTimers.Schedule(effectStart, payload);
+	}
+
+	void Systems::StartLifespanEffect(uint32_t entity, LifespanComponent& lifespan)
+	{
+		Entity handle = m_EntityManager->GetEntity(entity);
+		auto& shape = handle.GetComponent<ShapeComponent>();
+
+		// Steps from the start of the effect to the expiry, same split as ScheduleLifespan
+		int effectLength = std::min(lifespan.TotalTime, lifespan.ActionTime);
+
+		TweenValue from = { (float)shape.FillColor.a, (float)shape.OutlineColor.a, 0.0f, 0.0f };
+		TweenValue to = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		switch (lifespan.Effect)
+		{
+			case LifespanComponent::EffectTypes::Fade:
+			{
+				// Reaches zero on the last step before the entity expires
+				m_Tweens->Add(handle, TweenProperty::Alpha, from, to, effectLength * Time::GetFixedTimestep());
+				break;
+			}
+
+			case LifespanComponent::EffectTypes::Blink:
+			{
+				// Fades out and back in once a second until the entity expires
+				m_Tweens->Add(handle, TweenProperty::Alpha, from, to, 0.5f, Easing::Linear, true);
+				break;
 			}
+
+			default:
+				break;
 		}
 	}
 
@@ -4,39 +4,119 @@
 
 #include "Entity.h"
 #include "EntityManager.h"
+#include "SpatialHash.h"
+#include "Narrowphase.h"
+#include "MovementKernel.h"
+#include "Scheduler.h"
+#include "Tweens.h"
+#include "Particles.h"
+
+#include "Core/JobSystem.h"
+#include "Core/TimerWheel.h"
+
+#include "Window/Window.h"
+#include "Renderer/BatchRenderer.h"
 
 #include <functional>
+#include <array>
+#include <algorithm>
 
 namespace Eero {
 
-	typedef std::tuple<std::shared_ptr<Entity>, std::shared_ptr<Entity>> EntityPairs;
+	typedef std::tuple<Entity, Entity> EntityPairs;
 
-	// Collision (it has to be on its own because of the Check functions)
-	struct CollisionData
+	// Collision (it has to be on its own because of the OnCollision functions)
+	enum class BroadphaseMode
 	{
-		std::shared_ptr<Entity> EntityX;
-		std::shared_ptr<Entity> EntityY;
+		BruteForce = 0, SpatialHash = 1
 	};
 
+	constexpr uint32_t MaxCollisionLayers = 64;
+
 	class Collision
 	{
 		friend class Systems;
 	public:
-		void Listen(std::vector<std::shared_ptr<Entity>>& entities);
+		void Listen();
+		void Dispatch();
+
+		// Registered once, func gets every (tagX, tagY) contact of the frame with the entities in that order.
+		// Both tags have to be below MaxCollisionLayers, otherwise it asserts and nothing is registered.
+		void OnCollision(TagID tagX, TagID tagY, const std::function<void(EntityPairs)>& func);
+		void OnCollision(const std::string& tagX, const std::string& tagY, const std::function<void(EntityPairs)>& func);
+
+		// Layer interaction matrix, pairs of layers that don't interact are never tested.
+		// OnCollision enables its own pair of tags automatically. Layers out of range assert.
+		void SetLayerInteraction(uint32_t layerX, uint32_t layerY, bool interact);
+		bool LayersInteract(uint32_t layerX, uint32_t layerY) const { return (m_LayerMasks[layerX] >> layerY) & 1; }
+
+		// BruteForce is the N^2 reference, both modes report the same collisions
+		void SetBroadphase(BroadphaseMode mode) { m_Broadphase = mode; }
+		BroadphaseMode GetBroadphase() const { return m_Broadphase; }
+
+		// Instruction set of the narrowphase kernel, clamped to what the CPU supports
+		void SetNarrowphase(SIMDLevel level);
+		SIMDLevel GetNarrowphase() const { return m_Narrowphase; }
 
-		void CheckCollision(const std::string& tagX, const std::string& tagY, const std::function<void(EntityPairs)>& func);
+		// Sorted contacts of a set of circles with the current broadphase and narrowphase, no entities involved
+		const std::vector<std::pair<uint32_t, uint32_t>>& FindContacts(const std::vector<float>& posX, const std::vector<float>& posY, const std::vector<float>& radius, const std::vector<uint32_t>& layers);
 	private:
-		Collision() = default;
+		Collision(const std::shared_ptr<EntityManager>& entities, const std::shared_ptr<JobSystem>& jobs)
+			: m_EntityManager(entities), m_Jobs(jobs) {}
+
+		void FindContacts();
+		void BruteForcePairs();
+		void SpatialHashPairs();
+		void AddCollision(uint32_t indexX, uint32_t indexY);
 	private:
-		std::vector<std::shared_ptr<CollisionData>> m_Collisions;
-		std::vector<std::shared_ptr<Entity>> m_Entities;
+		struct CollisionHandler
+		{
+			TagID TagX, TagY;
+			std::function<void(EntityPairs)> Func;
+			std::vector<EntityPairs> Pairs; // reused every frame
+		};
+
+		// Broadphase output of one parallel_for chunk
+		struct BroadphaseChunk
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> Candidates;
+			NarrowphaseBatch Batch;
+			std::vector<uint8_t> Hits;
+			std::vector<std::pair<uint32_t, uint32_t>> Contacts;
+		};
+
+		static constexpr uint32_t s_NoHandler = UINT32_MAX;
+		static constexpr uint32_t s_SwappedBit = 1u << 31;
+		static constexpr size_t s_BroadphaseGrain = 256;
+
+		std::shared_ptr<EntityManager> m_EntityManager;
+		std::shared_ptr<JobSystem> m_Jobs;
+
+		std::vector<CollisionHandler> m_Handlers;
+		std::vector<uint32_t> m_HandlerTable; // [tagX * size + tagY] -> handler index, s_SwappedBit when stored as (tagY, tagX)
+		uint32_t m_HandlerTableSize = 0;
+
+		BroadphaseMode m_Broadphase = BroadphaseMode::SpatialHash;
+		SIMDLevel m_Narrowphase = SIMD::GetSupportedLevel();
+		SpatialHash m_SpatialHash;
+		std::array<uint64_t, MaxCollisionLayers> m_LayerMasks = {};
+
+		// Colliders of the current frame, kept between frames to reuse the memory
+		std::vector<CollisionComponent*> m_Colliders;
+		std::vector<Entity> m_ColliderEntities;
+		std::vector<float> m_PosX, m_PosY, m_Radius;
+		std::vector<uint32_t> m_Layers;
+		std::vector<TagID> m_Tags;
+		std::vector<BroadphaseChunk> m_Chunks;
+		std::vector<std::pair<uint32_t, uint32_t>> m_Contacts;
 	};
 
 	// Systems
 	struct SystemsProps
 	{
-		std::shared_ptr<sf::RenderWindow>& RenderWindow;
+		std::shared_ptr<Window>& Window;
 		std::shared_ptr<EntityManager>& EntityManager;
+		std::shared_ptr<JobSystem>& Jobs;
 	};
 
 	class Systems
@@ -45,19 +125,65 @@ namespace Eero {
 		Systems() = default;
 		Systems(const SystemsProps& props);
 
+		// Start of a simulation step, saves the transforms rendering interpolates from
+		void BeginStep();
 		void Run(float deltaTime);
+
+		// Copies what rendering needs out of the components, the render thread draws it
+		void WriteSnapshot(RenderSnapshot& snapshot);
+
+		// Generates the geometry of the visible shapes without drawing it, for headless runs.
+		// alpha = how far into the next step the frame is, 0..1
+		void BuildBatch(float alpha);
+
+		const RenderStats& GetRenderStats() const { return m_RenderStats; }
 		
 		std::shared_ptr<Collision>& GetCollision() { return m_Collision; }
+		std::shared_ptr<Scheduler>& GetScheduler() { return m_Scheduler; }
+		std::shared_ptr<TweenEngine>& GetTweens() { return m_Tweens; }
+		std::shared_ptr<ParticleSystem>& GetParticles() { return m_Particles; }
+		std::shared_ptr<BatchRenderer>& GetRenderer() { return m_Renderer; }
+
+		// Checks that every broadphase and narrowphase finds the same contacts as brute force + scalar
+		// on seeded random circles, touching pairs and circles on cell boundaries included. Rounds
+		// cycle through power of two and other cell sizes, and negative and large coordinates.
+		bool VerifyCollision(uint32_t seed);
+
+		// Instruction set of the movement kernel, clamped to what the CPU supports
+		void SetMovementKernel(SIMDLevel level) { m_SIMDLevel = std::min(level, SIMD::GetSupportedLevel()); }
 	private:
 		void Movement(float deltaTime);
-		void Render();
 		void Lifespan();
+
+		void ScheduleLifespan(uint32_t entity, LifespanComponent& lifespan);
+		void StartLifespanEffect(uint32_t entity, LifespanComponent& lifespan);
 	private:
-		std::shared_ptr<sf::RenderWindow> m_RenderWindow;
+		struct MovementChunk
+		{
+			std::vector<float> Radius; // per run of transforms, reused every step
+		};
+
+		static constexpr size_t s_MovementGrain = 1024;
+
+		std::shared_ptr<Window> m_Window;
 		std::shared_ptr<EntityManager> m_EntityManager;
-		std::vector<std::shared_ptr<Entity>> m_Entities;
+		std::shared_ptr<JobSystem> m_Jobs;
 
 		std::shared_ptr<Collision> m_Collision;
+		std::shared_ptr<Scheduler> m_Scheduler;
+		std::shared_ptr<TweenEngine> m_Tweens;
+		std::shared_ptr<ParticleSystem> m_Particles;
+		std::shared_ptr<BatchRenderer> m_Renderer;
+		RenderSnapshot m_Snapshot; // headless only
+		RenderStats m_RenderStats;
+
+		SIMDLevel m_SIMDLevel = SIMD::GetSupportedLevel();
+		float m_WorldWidth = 0.0f, m_WorldHeight = 0.0f;
+		std::vector<MovementChunk> m_MovementChunks;
+
+		// Lifespans are scheduled once when added, timer payload = entity << 32 | serial << 1 | expire
+		TimerWheel m_LifespanTimers;
+		uint32_t m_LifespanSerial = LifespanComponent::Unscheduled + 1;
 	};
 
 }
@@ -0,0 +1,193 @@
+#include "Tweens.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Eero {
+
+	void TweenEngine::Add(Entity entity, TweenProperty property, const TweenValue& from, const TweenValue& to, float duration, Easing easing, bool pingPong)
+	{
+		uint32_t index = entity.GetIndex();
+		if (index >= m_Lookup.size())
+		{
+			std::array<uint32_t, s_PropertyCount> empty;
+			empty.fill(s_NoTrack);
+			m_Lookup.resize(index + 1, empty);
+		}
+
+		Cancel(entity, property);
+
+		Lookup(index, property) = (uint32_t)m_Entities.size();
+
+		m_Entities.push_back(entity);
+		m_Properties.push_back(property);
+		m_Easings.push_back(easing);
+		m_PingPong.push_back(pingPong);
+		m_Elapsed.push_back(0.0f);
+		m_Durations.push_back(std::max(duration, 0.0001f));
+		m_From.push_back(from);
+		m_To.push_back(to);
+		m_Values.push_back(from);
+		m_Finished.push_back(false);
+	}
+
+	void TweenEngine::Cancel(Entity entity, TweenProperty property)
+	{
+		uint32_t index = entity.GetIndex();
+		if (index < m_Lookup.size() && Lookup(index, property) != s_NoTrack)
+			RemoveTrack(Lookup(index, property));
+	}
+
+	float TweenEngine::Ease(Easing easing, float t)
+	{
+		switch (easing)
+		{
+			case Easing::InQuad:
+				return t * t;
+
+			case Easing::OutQuad:
+				return t * (2.0f - t);
+
+			case Easing::InOutQuad:
+				return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+
+			default:
+				return t;
+		}
+	}
+
+	void TweenEngine::Update(float deltaTime)
+	{
+		// Fetched here, GetPool can grow the pool table
+		auto& shapes = m_EntityManager->GetPool<ShapeComponent>();
+
+		// An entity has at most one track per property and every property writes its own
+		// fields of the shape, so chunks never touch the same memory
+		m_Jobs->ParallelFor(m_Entities.size(), s_Grain, [&](size_t begin, size_t end, size_t)
+		{
+			for (size_t track = begin; track < end; track++)
+			{
+				float elapsed = m_Elapsed[track] + deltaTime;
+				float duration = m_Durations[track];
+				m_Elapsed[track] = elapsed;
+
+				float t;
+				if (m_PingPong[track])
+				{
+					float phase = std::fmod(elapsed, 2.0f * duration) / duration;
+					t = phase <= 1.0f ? phase : 2.0f - phase;
+				}
+				else
+				{
+					t = std::min(elapsed / duration, 1.0f);
+				}
+
+				float eased = Ease(m_Easings[track], t);
+
+				auto& from = m_From[track];
+				auto& to = m_To[track];
+				auto& value = m_Values[track];
+
+				for (size_t lane = 0; lane < value.size(); lane++)
+				{
+					value[lane] = from[lane] + (to[lane] - from[lane]) * eased;
+				}
+
+				Entity entity = m_Entities[track];
+				if (!entity.IsValid() || !shapes.Has(entity.GetIndex()))
+				{
+					m_Finished[track] = true;
+					continue;
+				}
+
+				Write(track, shapes.Get(entity.GetIndex()));
+				m_Finished[track] = !m_PingPong[track] && elapsed >= duration;
+			}
+		});
+
+		// Backwards so the track swapped into a removed spot has already been checked
+		for (size_t track = m_Entities.size(); track-- > 0;)
+		{
+			if (m_Finished[track])
+				RemoveTrack(track);
+		}
+	}
+
+	void TweenEngine::Write(size_t track, ShapeComponent& shape)
+	{
+		auto& value = m_Values[track];
+
+		auto toChannel = [](float channel) { return (sf::Uint8)std::clamp(channel + 0.5f, 0.0f, 255.0f); };
+
+		switch (m_Properties[track])
+		{
+			case TweenProperty::Alpha:
+			{
+				shape.FillColor.a = toChannel(value[0]);
+				shape.OutlineColor.a = toChannel(value[1]);
+				break;
+			}
+
+			case TweenProperty::Scale:
+			{
+				shape.Scale = value[0];
+				break;
+			}
+
+			case TweenProperty::FillColor:
+			{
+				// Channel by channel, alpha belongs to the Alpha track
+				shape.FillColor.r = toChannel(value[0]);
+				shape.FillColor.g = toChannel(value[1]);
+				shape.FillColor.b = toChannel(value[2]);
+				break;
+			}
+
+			case TweenProperty::OutlineColor:
+			{
+				shape.OutlineColor.r = toChannel(value[0]);
+				shape.OutlineColor.g = toChannel(value[1]);
+				shape.OutlineColor.b = toChannel(value[2]);
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	// Swap and pop, the lookup of the moved track is patched
+	void TweenEngine::RemoveTrack(size_t track)
+	{
+		Lookup(m_Entities[track].GetIndex(), m_Properties[track]) = s_NoTrack;
+
+		size_t last = m_Entities.size() - 1;
+		if (track != last)
+		{
+			m_Entities[track] = m_Entities[last];
+			m_Properties[track] = m_Properties[last];
+			m_Easings[track] = m_Easings[last];
+			m_PingPong[track] = m_PingPong[last];
+			m_Elapsed[track] = m_Elapsed[last];
+			m_Durations[track] = m_Durations[last];
+			m_From[track] = m_From[last];
+			m_To[track] = m_To[last];
+			m_Values[track] = m_Values[last];
+			m_Finished[track] = m_Finished[last];
+
+			Lookup(m_Entities[track].GetIndex(), m_Properties[track]) = (uint32_t)track;
+		}
+
+		m_Entities.pop_back();
+		m_Properties.pop_back();
+		m_Easings.pop_back();
+		m_PingPong.pop_back();
+		m_Elapsed.pop_back();
+		m_Durations.pop_back();
+		m_From.pop_back();
+		m_To.pop_back();
+		m_Values.pop_back();
+		m_Finished.pop_back();
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Entity.h"
+#include "EntityManager.h"
+
+#include "Core/JobSystem.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// What a track animates on the entity's shape, and which value lanes it uses
+	enum class TweenProperty : uint8_t
+	{
+		Alpha = 0,       // fill alpha, outline alpha
+		Scale = 1,       // uniform scale
+		FillColor = 2,   // r, g, b
+		OutlineColor = 3 // r, g, b
+	};
+
+	enum class Easing : uint8_t
+	{
+		Linear = 0, InQuad = 1, OutQuad = 2, InOutQuad = 3
+	};
+
+	using TweenValue = std::array<float, 4>;
+
+	// Animation tracks kept in packed arrays. Every step all tracks are advanced, evaluated
+	// and written into the shapes in one parallel pass, finished ones are removed after.
+	class TweenEngine
+	{
+	public:
+		TweenEngine(const std::shared_ptr<EntityManager>& entities, const std::shared_ptr<JobSystem>& jobs)
+			: m_EntityManager(entities), m_Jobs(jobs) {}
+
+		// Replaces the track the entity already has for the property. Duration is in seconds,
+		// ping-pong tracks go back and forth until they're cancelled or the entity is gone.
+		void Add(Entity entity, TweenProperty property, const TweenValue& from, const TweenValue& to, float duration, Easing easing = Easing::Linear, bool pingPong = false);
+		void Cancel(Entity entity, TweenProperty property);
+
+		void Update(float deltaTime);
+
+		size_t GetTrackCount() const { return m_Entities.size(); }
+
+		static float Ease(Easing easing, float t);
+	private:
+		void Write(size_t track, ShapeComponent& shape);
+		void RemoveTrack(size_t track);
+
+		uint32_t& Lookup(uint32_t entity, TweenProperty property) { return m_Lookup[entity][(size_t)property]; }
+	private:
+		static constexpr size_t s_Grain = 2048;
+		static constexpr uint32_t s_NoTrack = UINT32_MAX;
+		static constexpr size_t s_PropertyCount = 4;
+
+		std::shared_ptr<EntityManager> m_EntityManager;
+		std::shared_ptr<JobSystem> m_Jobs;
+
+		// One entry per track
+		std::vector<Entity> m_Entities;
+		std::vector<TweenProperty> m_Properties;
+		std::vector<Easing> m_Easings;
+		std::vector<uint8_t> m_PingPong;
+		std::vector<float> m_Elapsed;
+		std::vector<float> m_Durations;
+		std::vector<TweenValue> m_From;
+		std::vector<TweenValue> m_To;
+		std::vector<TweenValue> m_Values;
+		std::vector<uint8_t> m_Finished;
+
+		// Entity index -> track of every property, grows with the entity slots
+		std::vector<std::array<uint32_t, s_PropertyCount>> m_Lookup;
+	};
+
+}
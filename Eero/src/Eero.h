@@ -3,5 +3,6 @@
 #include "Core/Application.h"
 #include "Core/Entrypoint.h"
 #include "Core/Math.h"
+#include "Core/TimerWheel.h"
 #include "Event/KeyMouseCodes.h"
 
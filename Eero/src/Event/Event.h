@@ -1,64 +1,70 @@
 #pragma once
 
-#include <memory>
-
 #include <SFML/Graphics.hpp>
 
+#include <chrono>
+#include <cstdint>
+
 namespace Eero {
 
+	enum class EventType : uint8_t
+	{
+		None = 0,
+		KeyPressed, KeyReleased,
+		MouseButtonPressed, MouseButtonReleased, MouseMoved,
+		WindowClosed, WindowResized
+	};
+
 	struct KeyPressedEvent
 	{
 		sf::Keyboard::Key KeyCode;
-
-		KeyPressedEvent(sf::Keyboard::Key& key)
-			: KeyCode(key) {}
 	};
 
 	struct KeyReleasedEvent
 	{
 		sf::Keyboard::Key KeyCode;
-
-		KeyReleasedEvent(sf::Keyboard::Key& key)
-			: KeyCode(key) {}
 	};
 
 	struct MouseButtonPressedEvent
 	{
 		sf::Mouse::Button MouseButton;
-		float MousePosX, MousePosY = 0.0f;
+		float MousePosX, MousePosY;
+	};
 
-		MouseButtonPressedEvent(sf::Mouse::Button& button, float mouseX, float mouseY)
-			: MouseButton(button), MousePosX(mouseX), MousePosY(mouseY) {}
+	struct MouseButtonReleasedEvent
+	{
+		sf::Mouse::Button MouseButton;
+		float MousePosX, MousePosY;
 	};
 
 	struct MouseMovedEvent
 	{
-		float PosX, PosY = 0.0f;
-
-		MouseMovedEvent(float x, float y)
-			: PosX(x), PosY(y) {}
+		float PosX, PosY;
 	};
 
 	struct WindowEvent
 	{
-		std::string Type = "Default";
-		float Width, Height = 0.0f;
-
-		WindowEvent(std::string type)
-			: Type(type) {}
-		WindowEvent(std::string type, float x, float y)
-			: Type(type), Width(x), Height(y) {}
+		float Width, Height; // resized only
 	};
 
-	class Event
+	// Tagged union, Type says which member is valid. Plain data so the queue can reuse its slots.
+	struct Event
 	{
-	public:
-		std::shared_ptr<KeyPressedEvent> eKeyPressed;
-		std::shared_ptr<KeyReleasedEvent> eKeyReleased;
-		std::shared_ptr<MouseButtonPressedEvent> eMouseButton;
-		std::shared_ptr<MouseMovedEvent> eMouseMoved;
-		std::shared_ptr<WindowEvent> eWindow;
-		bool m_Handled = false;
+		EventType Type = EventType::None;
+		bool Handled = false;
+		std::chrono::steady_clock::time_point Time; // when the input came in
+
+		union
+		{
+			KeyPressedEvent KeyPressed;
+			KeyReleasedEvent KeyReleased;
+			MouseButtonPressedEvent MouseButton;
+			MouseButtonReleasedEvent MouseButtonReleased;
+			MouseMovedEvent MouseMoved;
+			WindowEvent Window;
+		};
+
+		Event() : Window{ 0.0f, 0.0f } {}
 	};
 
 }
@@ -1,91 +1,85 @@
 #include "EventHandler.h"
 
+#include <algorithm>
+
 namespace Eero {
 
-	EventHandler::EventHandler(const std::shared_ptr<sf::RenderWindow>& window)
-		: m_Window(window) 
+	EventHandler::EventHandler(const std::shared_ptr<InputThread>& source)
+		: m_Source(source) 
 	{
 		Clear();
 	}
 
 	void EventHandler::Listen()
 	{
-		sf::Event sfEvent;
-
-		while (m_Window->pollEvent(sfEvent))
+		if (m_Source)
 		{
-			switch (sfEvent.type)
-			{
-				case sf::Event::KeyPressed:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eKeyPressed = std::make_shared<KeyPressedEvent>(sfEvent.key.code);
-
-					m_Events["keyPressed"].push_back(eventX);
-
-					break;
-				}
-
-				case sf::Event::KeyReleased:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eKeyReleased = std::make_shared<KeyReleasedEvent>(sfEvent.key.code);
-
-					m_Events["keyReleased"].push_back(eventX);
-
-					break;
-				}
-
-				case sf::Event::MouseButtonPressed:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eMouseButton = std::make_shared<MouseButtonPressedEvent>(sfEvent.mouseButton.button, sfEvent.mouseButton.x, sfEvent.mouseButton.y);
+			TimedEvent event;
 
-					m_Events["mouseButton"].push_back(eventX);
-
-					break;
-				}
-
-				case sf::Event::MouseMoved:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eMouseMoved = std::make_shared<MouseMovedEvent>(sfEvent.mouseMove.x, sfEvent.mouseMove.y);
-
-					m_Events["mouseMoved"].push_back(eventX);
-
-					break;
-				}
-
-				case sf::Event::Closed:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eWindow = std::make_shared<WindowEvent>("closed");
+			while (m_Source->Poll(event))
+			{
+				Translate(event.Event, event.Time);
+			}
+		}
+	}
 
-					m_Events["window"].push_back(eventX);
+	void EventHandler::Translate(const sf::Event& sfEvent, std::chrono::steady_clock::time_point time)
+	{
+		switch (sfEvent.type)
+		{
+			case sf::Event::KeyPressed:
+			{
+				m_Events.Push(EventType::KeyPressed, time).KeyPressed = { sfEvent.key.code };
+				break;
+			}
 
-					break;
-				}
+			case sf::Event::KeyReleased:
+			{
+				m_Events.Push(EventType::KeyReleased, time).KeyReleased = { sfEvent.key.code };
+				break;
+			}
 
-				case sf::Event::Resized:
-				{
-					auto eventX = std::make_shared<Event>();
-					eventX->eWindow = std::make_shared<WindowEvent>("resized", sfEvent.size.width, sfEvent.size.height);
+			case sf::Event::MouseButtonPressed:
+			{
+				m_Events.Push(EventType::MouseButtonPressed, time).MouseButton = { sfEvent.mouseButton.button, (float)sfEvent.mouseButton.x, (float)sfEvent.mouseButton.y };
+				break;
+			}
 
-					m_Events["window"].push_back(eventX);
+			case sf::Event::MouseButtonReleased:
+			{
+				m_Events.Push(EventType::MouseButtonReleased, time).MouseButtonReleased = { sfEvent.mouseButton.button, (float)sfEvent.mouseButton.x, (float)sfEvent.mouseButton.y };
+				break;
+			}
 
-					break;
-				}
+			case sf::Event::MouseMoved:
+			{
+				m_Events.Push(EventType::MouseMoved, time).MouseMoved = { (float)sfEvent.mouseMove.x, (float)sfEvent.mouseMove.y };
+				break;
+			}
 
+			case sf::Event::Closed:
+			{
+				m_Events.Push(EventType::WindowClosed, time);
+				break;
+			}
 
-				default:
-					break;
+			case sf::Event::Resized:
+			{
+				m_Events.Push(EventType::WindowResized, time).Window = { (float)sfEvent.size.width, (float)sfEvent.size.height };
+				break;
 			}
+
+			default:
+				return;
 		}
+
+		m_OldestTime = std::min(m_OldestTime, time);
 	}
 
 	void EventHandler::Clear()
 	{
-		m_Events.clear();
+		m_Events.Clear();
+		m_OldestTime = std::chrono::steady_clock::time_point::max();
 	}
 
 }
\ No newline at end of file
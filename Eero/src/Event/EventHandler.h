@@ -1,25 +1,33 @@
 #pragma once
 
-#include <vector>
-#include <string>
-#include <map>
-
 #include "Event.h"
+#include "EventQueue.h"
+#include "InputThread.h"
 
 namespace Eero {
 
 	class EventHandler
 	{
 	public:
-		EventHandler(const std::shared_ptr<sf::RenderWindow>& window);
+		EventHandler(const std::shared_ptr<InputThread>& source);
 
+		// Takes in everything the input thread has polled since the last call
 		void Listen();
 		void Clear();
 
-		std::map<std::string, std::vector<std::shared_ptr<Event>>>& GetEvents() { return m_Events; }
+		// Programmatic input, goes into the queue like a window event
+		void Push(const sf::Event& event) { Translate(event, std::chrono::steady_clock::now()); }
+
+		EventQueue& GetEvents() { return m_Events; }
+
+		// Earliest input of the current events, used for the input latency
+		std::chrono::steady_clock::time_point GetOldestTime() const { return m_OldestTime; }
+	private:
+		void Translate(const sf::Event& sfEvent, std::chrono::steady_clock::time_point time);
 	private:
-		std::shared_ptr<sf::RenderWindow> m_Window;
-		std::map<std::string, std::vector<std::shared_ptr<Event>>> m_Events;
+		std::shared_ptr<InputThread> m_Source; // null when headless
+		EventQueue m_Events;
+		std::chrono::steady_clock::time_point m_OldestTime = std::chrono::steady_clock::time_point::max();
 	};
 
 }
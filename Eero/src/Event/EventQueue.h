@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Event.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// Ring buffer of the events of the current frame, slots are reused every frame. When it's full
+	// a new event that can be missed is dropped and counted. Closes, resizes and releases never
+	// are, they push out the oldest event that can be missed, or grow the ring if there's none.
+	class EventQueue
+	{
+	public:
+		static constexpr uint32_t Capacity = 256; // to begin with
+
+		EventQueue()
+			: m_Events(Capacity), m_Mask(Capacity - 1) {}
+
+		Event& Push(EventType type, std::chrono::steady_clock::time_point time)
+		{
+			if (m_Count == m_Events.size())
+			{
+				// Handed out so the caller can fill it in, never read
+				if (!IsCritical(type))
+				{
+					m_Dropped++;
+					return m_Overflow;
+				}
+
+				if (RemoveOldestMissable())
+					m_Dropped++;
+				else
+					Grow();
+			}
+
+			Event& event = m_Events[(m_Head + m_Count++) & m_Mask];
+			event.Type = type;
+			event.Handled = false;
+			event.Time = time;
+			return event;
+		}
+
+		// Losing one of these quits nothing or leaves a key stuck
+		static bool IsCritical(EventType type)
+		{
+			return type == EventType::WindowClosed || type == EventType::WindowResized || type == EventType::KeyReleased || type == EventType::MouseButtonReleased;
+		}
+
+		void Clear()
+		{
+			m_Head = (m_Head + m_Count) & m_Mask;
+			m_Count = 0;
+		}
+
+		uint32_t Size() const { return m_Count; }
+		uint32_t GetCapacity() const { return (uint32_t)m_Events.size(); }
+		bool Empty() const { return m_Count == 0; }
+		uint32_t GetDroppedCount() const { return m_Dropped; }
+
+		Event& operator [] (uint32_t index) { return m_Events[(m_Head + index) & m_Mask]; }
+		const Event& operator [] (uint32_t index) const { return m_Events[(m_Head + index) & m_Mask]; }
+
+		template<typename QueueType, typename EventRef>
+		class Iterator
+		{
+		public:
+			Iterator(QueueType* queue, uint32_t index)
+				: m_Queue(queue), m_Index(index) {}
+
+			EventRef operator * () const { return (*m_Queue)[m_Index]; }
+			Iterator& operator ++ () { m_Index++; return *this; }
+			bool operator != (const Iterator& other) const { return m_Index != other.m_Index; }
+		private:
+			QueueType* m_Queue;
+			uint32_t m_Index;
+		};
+
+		// Oldest first
+		Iterator<EventQueue, Event&> begin() { return { this, 0 }; }
+		Iterator<EventQueue, Event&> end() { return { this, m_Count }; }
+		Iterator<const EventQueue, const Event&> begin() const { return { this, 0 }; }
+		Iterator<const EventQueue, const Event&> end() const { return { this, m_Count }; }
+	private:
+		// Keeps the order, later events move one slot back
+		bool RemoveOldestMissable()
+		{
+			for (uint32_t i = 0; i < m_Count; i++)
+			{
+				if (IsCritical((*this)[i].Type))
+					continue;
+
+				for (uint32_t j = i + 1; j < m_Count; j++)
+				{
+					(*this)[j - 1] = (*this)[j];
+				}
+
+				m_Count--;
+				return true;
+			}
+
+			return false;
+		}
+
+		// Twice the size, unrolled so the oldest event lands in slot 0
+		void Grow()
+		{
+			std::vector<Event> events(m_Events.size() * 2);
+			for (uint32_t i = 0; i < m_Count; i++)
+			{
+				events[i] = (*this)[i];
+			}
+
+			m_Events = std::move(events);
+			m_Mask = (uint32_t)m_Events.size() - 1;
+			m_Head = 0;
+		}
+	private:
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+		std::vector<Event> m_Events;
+		uint32_t m_Mask;
+		Event m_Overflow;
+		uint32_t m_Head = 0;
+		uint32_t m_Count = 0;
+		uint32_t m_Dropped = 0;
+	};
+
+}
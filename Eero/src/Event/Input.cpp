@@ -2,89 +2,59 @@
 
 namespace Eero {
 
-	bool Input::KeyPressed(const sf::Keyboard::Key& key)
+	void Input::Ingest(const EventQueue& events)
 	{
-		for (auto& [tag, eventVec] : m_Events)
+		for (auto& e : events)
 		{
-			if (tag == "keyPressed")
+			switch (e.Type)
 			{
-				for (auto& e : eventVec)
+				case EventType::KeyPressed:
 				{
-					if (e->eKeyPressed->KeyCode == key && !e->m_Handled)
-					{
-						e->m_Handled = true;
-						return true;
-					}
+					Press(m_KeysDown, m_KeysPressed, e.KeyPressed.KeyCode);
+					break;
 				}
-			}
-		}
-
-		return false;
-	}
 
-	bool Input::KeyReleased(const sf::Keyboard::Key& key)
-	{
-		for (auto& [tag, eventVec] : m_Events)
-		{
-			if (tag == "keyReleased")
-			{
-				for (auto& e : eventVec)
+				case EventType::KeyReleased:
 				{
-					if (e->eKeyReleased->KeyCode == key && !e->m_Handled)
-					{
-						e->m_Handled = true;
-						return true;
-					}
+					Release(m_KeysDown, m_KeysReleased, e.KeyReleased.KeyCode);
+					break;
 				}
-			}
-		}
-
-		return false;
-	}
 
-	bool Input::MouseButtonPressed(const sf::Mouse::Button& button)
-	{
-		for (auto& [tag, eventVec] : m_Events)
-		{
-			if (tag == "mouseButton")
-			{
-				for (auto& e : eventVec)
+				case EventType::MouseButtonPressed:
 				{
-					if (e->eMouseButton->MouseButton == button && !e->m_Handled)
-					{
-						// Set the mouse position when it is only clicked
-						m_MousePosX = e->eMouseButton->MousePosX;
-						m_MousePosY = e->eMouseButton->MousePosY;
-
-						e->m_Handled = true;
-						return true;
-					}
+					Press(m_ButtonsDown, m_ButtonsPressed, e.MouseButton.MouseButton);
+					m_MousePosX = e.MouseButton.MousePosX;
+					m_MousePosY = e.MouseButton.MousePosY;
+					break;
 				}
-			}
-		}
 
-		return false;
-	}
+				case EventType::MouseButtonReleased:
+				{
+					Release(m_ButtonsDown, m_ButtonsReleased, e.MouseButtonReleased.MouseButton);
+					m_MousePosX = e.MouseButtonReleased.MousePosX;
+					m_MousePosY = e.MouseButtonReleased.MousePosY;
+					break;
+				}
 
-	std::tuple<float, float> Input::GetMousePosition()
-	{
-		for (auto& [tag, eventVec] : m_Events)
-		{
-			if (tag == "mouseMoved")
-			{
-				for (auto& e : eventVec)
+				case EventType::MouseMoved:
 				{
-					if (!e->m_Handled)
-					{
-						m_MousePosX = e->eMouseMoved->PosX;
-						m_MousePosY = e->eMouseMoved->PosY;
-						e->m_Handled = true;
-					}
+					m_MousePosX = e.MouseMoved.PosX;
+					m_MousePosY = e.MouseMoved.PosY;
+					break;
 				}
+
+				default:
+					break;
 			}
 		}
+	}
 
-		return { m_MousePosX, m_MousePosY };
+	void Input::EndStep()
+	{
+		m_KeysPressed.reset();
+		m_KeysReleased.reset();
+		m_ButtonsPressed.reset();
+		m_ButtonsReleased.reset();
 	}
 
 }
\ No newline at end of file
@@ -2,20 +2,60 @@
 
 #include "EventHandler.h"
 
+#include <bitset>
+#include <tuple>
+
 namespace Eero {
 
+	// Key and button state of the current step, built once from the events so every query is
+	// a bit test. Pressed and released stay set until the end of the next simulation step,
+	// down holds until the release comes in.
 	class Input
 	{
 	public:
-		bool KeyPressed(const sf::Keyboard::Key& key);
-		bool KeyReleased(const sf::Keyboard::Key& key);
-		bool MouseButtonPressed(const sf::Mouse::Button& button);
-		std::tuple<float, float> GetMousePosition();
+		bool KeyPressed(const sf::Keyboard::Key& key) const { return Test(m_KeysPressed, key); }
+		bool KeyReleased(const sf::Keyboard::Key& key) const { return Test(m_KeysReleased, key); }
+		bool KeyDown(const sf::Keyboard::Key& key) const { return Test(m_KeysDown, key); }
+
+		bool MouseButtonPressed(const sf::Mouse::Button& button) const { return Test(m_ButtonsPressed, button); }
+		bool MouseButtonReleased(const sf::Mouse::Button& button) const { return Test(m_ButtonsReleased, button); }
+		bool MouseButtonDown(const sf::Mouse::Button& button) const { return Test(m_ButtonsDown, button); }
+
+		// Latest cursor position from a move or a click
+		std::tuple<float, float> GetMousePosition() const { return { m_MousePosX, m_MousePosY }; }
+
+		// Applies the frame's events in order
+		void Ingest(const EventQueue& events);
+
+		// Clears pressed and released after a simulation step has seen them
+		void EndStep();
+	private:
+		template<size_t Size>
+		static bool Test(const std::bitset<Size>& bits, int code) { return code >= 0 && code < (int)Size && bits[code]; }
+
+		template<size_t Size>
+		static void Press(std::bitset<Size>& down, std::bitset<Size>& pressed, int code)
+		{
+			if (code < 0 || code >= (int)Size)
+				return;
+
+			down[code] = true;
+			pressed[code] = true;
+		}
+
+		template<size_t Size>
+		static void Release(std::bitset<Size>& down, std::bitset<Size>& released, int code)
+		{
+			if (code < 0 || code >= (int)Size)
+				return;
 
-		void SetEventList(std::map<std::string, std::vector<std::shared_ptr<Event>>> events) { m_Events = events; }
+			down[code] = false;
+			released[code] = true;
+		}
 	private:
-		std::map<std::string, std::vector<std::shared_ptr<Event>>> m_Events;
-		float m_MousePosX, m_MousePosY = 0.0f;
+		std::bitset<sf::Keyboard::KeyCount> m_KeysDown, m_KeysPressed, m_KeysReleased;
+		std::bitset<sf::Mouse::ButtonCount> m_ButtonsDown, m_ButtonsPressed, m_ButtonsReleased;
+		float m_MousePosX = 0.0f, m_MousePosY = 0.0f;
 	};
 
 }
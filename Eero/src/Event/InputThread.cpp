@@ -0,0 +1,65 @@
+#include "InputThread.h"
+
+namespace Eero {
+
+	InputThread::~InputThread()
+	{
+		Stop();
+	}
+
+	void InputThread::Start()
+	{
+		if (m_Running)
+			return;
+
+		m_Running = true;
+
+		std::promise<void> opened;
+		std::future<void> ready = opened.get_future();
+
+		m_Thread = std::thread(&InputThread::Loop, this, std::ref(opened));
+		ready.wait();
+	}
+
+	void InputThread::Stop()
+	{
+		if (!m_Running)
+			return;
+
+		m_Running = false;
+		m_Thread.join();
+	}
+
+	void InputThread::Loop(std::promise<void>& opened)
+	{
+		m_Window->Open();
+
+		// The render thread makes the context current on its own thread
+		auto& renderWindow = m_Window->GetWindow();
+		renderWindow->setActive(false);
+
+		opened.set_value();
+
+		while (m_Running)
+		{
+			sf::Event sfEvent;
+
+			while (renderWindow->pollEvent(sfEvent))
+			{
+				TimedEvent event = { sfEvent, std::chrono::steady_clock::now() };
+
+				// Full only when the main thread stalls, wait for it rather than lose input
+				while (!m_Queue.TryPush(event) && m_Running)
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			std::this_thread::sleep_for(s_PollInterval);
+		}
+
+		// Destroyed on the thread that created it
+		m_Window->Shutdown();
+	}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/SPSCQueue.h"
+#include "Window/Window.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace Eero {
+
+	struct TimedEvent
+	{
+		sf::Event Event;
+		std::chrono::steady_clock::time_point Time; // when the input thread polled it
+	};
+
+	// Opens the window and polls its events on a thread of its own, the OS wants events handled
+	// on the thread that created the window. Events are timestamped and handed to the main
+	// thread through a lock-free queue, so input never waits for a frame to finish.
+	class InputThread
+	{
+	public:
+		InputThread(const std::shared_ptr<Window>& window)
+			: m_Window(window) {}
+		~InputThread();
+
+		// Returns once the window is open
+		void Start();
+
+		// Closes the window, rendering has to be stopped before
+		void Stop();
+
+		// Main thread only
+		bool Poll(TimedEvent& event) { return m_Queue.TryPop(event); }
+	private:
+		void Loop(std::promise<void>& opened);
+	private:
+		static constexpr size_t s_QueueCapacity = 1024;
+		static constexpr std::chrono::microseconds s_PollInterval{ 500 };
+
+		std::shared_ptr<Window> m_Window;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running = false;
+
+		SPSCQueue<TimedEvent, s_QueueCapacity> m_Queue;
+	};
+
+}
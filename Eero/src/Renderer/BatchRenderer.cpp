@@ -0,0 +1,83 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Eero {
+
+	BatchRenderer::BatchRenderer()
+		: m_Vertices(sf::Triangles) {}
+
+	void BatchRenderer::Build(const RenderSnapshot& snapshot, float alpha, const sf::FloatRect& view, RenderStats& stats)
+	{
+		m_Vertices.clear();
+		m_ShapeCount = 0;
+		m_DrawCalls = 0;
+
+		stats = {};
+		stats.ShapesTransparent = snapshot.TransparentShapes;
+
+		float left = view.left, top = view.top;
+		float right = view.left + view.width, bottom = view.top + view.height;
+
+		// One pass, shapes go out in their original order so overlaps look the same. A direct
+		// circle against rect test per shape beats building a spatial index every frame.
+		for (auto& shape : snapshot.Shapes)
+		{
+			float x = shape.PrevX + (shape.X - shape.PrevX) * alpha;
+			float y = shape.PrevY + (shape.Y - shape.PrevY) * alpha;
+			float radius = shape.Mesh->BoundingRadius * std::abs(shape.Scale);
+
+			float dx = x - std::clamp(x, left, right);
+			float dy = y - std::clamp(y, top, bottom);
+
+			if (dx * dx + dy * dy > radius * radius)
+			{
+				stats.ShapesCulled++;
+				continue;
+			}
+
+			sf::Transform placement;
+			placement.translate(x, y).rotate(shape.PrevAngle + (shape.Angle - shape.PrevAngle) * alpha);
+
+			DrawShape(shape, placement);
+			stats.ShapesDrawn++;
+		}
+
+		stats.Vertices = (uint32_t)m_Vertices.getVertexCount();
+		stats.DrawCalls = stats.ShapesDrawn > 0 ? 1 : 0;
+	}
+
+	void BatchRenderer::DrawShape(const ShapeSnapshot& shape, const sf::Transform& placement)
+	{
+		// Scale applies to the outline too, same as sf::Shape
+		sf::Transform transform = placement;
+		transform.scale(shape.Scale, shape.Scale);
+
+		AppendMesh(shape.Mesh->Fill, transform, shape.FillColor);
+		AppendMesh(shape.Mesh->Outline, transform, shape.OutlineColor);
+
+		m_ShapeCount++;
+	}
+
+	void BatchRenderer::AppendMesh(const std::vector<sf::Vector2f>& mesh, const sf::Transform& transform, const sf::Color& color)
+	{
+		size_t base = m_Vertices.getVertexCount();
+		m_Vertices.resize(base + mesh.size());
+
+		for (size_t i = 0; i < mesh.size(); i++)
+		{
+			m_Vertices[base + i] = sf::Vertex(transform.transformPoint(mesh[i]), color);
+		}
+	}
+
+	void BatchRenderer::Flush(sf::RenderTarget& target)
+	{
+		if (m_Vertices.getVertexCount() == 0)
+			return;
+
+		target.draw(m_Vertices);
+		m_DrawCalls++;
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "RenderSnapshot.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	struct RenderStats
+	{
+		uint32_t ShapesDrawn = 0;
+		uint32_t ShapesCulled = 0;      // outside the view
+		uint32_t ShapesTransparent = 0; // alpha 0, rejected before culling
+		uint32_t TextsDrawn = 0;
+		uint32_t TextsCulled = 0;
+		uint32_t DrawCalls = 0;
+		uint32_t Vertices = 0;
+		float InputLatency = 0.0f;      // seconds from the oldest new input to the Display showing it, 0 without new input
+	};
+
+	// Collects the cached fill and outline geometry of every visible shape of a snapshot
+	// into one triangle list and draws it with a single call. All shapes share the default
+	// render states so there's only one batch, text is still drawn on its own.
+	class BatchRenderer
+	{
+	public:
+		BatchRenderer();
+
+		// Culls against view and generates the geometry, alpha interpolates between the
+		// previous and the current step. Doesn't need a window.
+		void Build(const RenderSnapshot& snapshot, float alpha, const sf::FloatRect& view, RenderStats& stats);
+		void Flush(sf::RenderTarget& target);
+
+		const sf::VertexArray& GetVertices() const { return m_Vertices; }
+		uint32_t GetShapeCount() const { return m_ShapeCount; }
+		uint32_t GetDrawCalls() const { return m_DrawCalls; }
+	private:
+		// placement = position and rotation of the shape's center
+		void DrawShape(const ShapeSnapshot& shape, const sf::Transform& placement);
+		void AppendMesh(const std::vector<sf::Vector2f>& mesh, const sf::Transform& transform, const sf::Color& color);
+	private:
+		sf::VertexArray m_Vertices;
+
+		uint32_t m_ShapeCount = 0;
+		uint32_t m_DrawCalls = 0;
+	};
+
+}
@@ -0,0 +1,109 @@
+#include "GeometryCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Eero {
+
+	std::mutex GeometryCache::s_Mutex;
+	std::unordered_map<GeometryCache::Key, ShapeMesh, GeometryCache::KeyHash> GeometryCache::s_Meshes;
+
+	static sf::Vector2f ComputeNormal(const sf::Vector2f& p1, const sf::Vector2f& p2)
+	{
+		sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+
+		if (length != 0.0f)
+			normal /= length;
+
+		return normal;
+	}
+
+	size_t GeometryCache::KeyHash::operator () (const Key& key) const
+	{
+		uint32_t radius, thickness;
+		std::memcpy(&radius, &key.Radius, sizeof(radius));
+		std::memcpy(&thickness, &key.Thickness, sizeof(thickness));
+
+		return ((size_t)radius * 73856093u) ^ ((size_t)key.Points * 19349663u) ^ ((size_t)thickness * 83492791u);
+	}
+
+	const ShapeMesh* GeometryCache::Get(float radius, int points, float thickness)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto [it, inserted] = s_Meshes.try_emplace({ radius, points, thickness });
+		if (inserted)
+			Build(it->second, radius, points, thickness);
+
+		return &it->second;
+	}
+
+	void GeometryCache::Build(ShapeMesh& mesh, float radius, int points, float thickness)
+	{
+		if (points < 3)
+			return;
+
+		size_t count = points;
+
+		// Same points as sf::CircleShape, relative to its center
+		std::vector<sf::Vector2f> polygon(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			float angle = i * 2.0f * 3.141592654f / count - 3.141592654f / 2.0f;
+			polygon[i] = { std::cos(angle) * radius, std::sin(angle) * radius };
+		}
+
+		// Fill, fanned out from the center
+		mesh.BoundingRadius = std::abs(radius);
+
+		mesh.Fill.reserve(count * 3);
+		for (size_t i = 0; i < count; i++)
+		{
+			mesh.Fill.push_back({ 0.0f, 0.0f });
+			mesh.Fill.push_back(polygon[i]);
+			mesh.Fill.push_back(polygon[(i + 1) % count]);
+		}
+
+		if (thickness == 0.0f)
+			return;
+
+		// Outline, extruded along the averaged edge normals like sf::Shape does
+		std::vector<sf::Vector2f> outer(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const sf::Vector2f& p0 = polygon[(i + count - 1) % count];
+			const sf::Vector2f& p1 = polygon[i];
+			const sf::Vector2f& p2 = polygon[(i + 1) % count];
+
+			sf::Vector2f n1 = ComputeNormal(p0, p1);
+			sf::Vector2f n2 = ComputeNormal(p1, p2);
+
+			// Point the normals away from the center
+			if (n1.x * -p1.x + n1.y * -p1.y > 0.0f)
+				n1 = -n1;
+			if (n2.x * -p1.x + n2.y * -p1.y > 0.0f)
+				n2 = -n2;
+
+			float factor = 1.0f + (n1.x * n2.x + n1.y * n2.y);
+			outer[i] = p1 + (n1 + n2) / factor * thickness;
+			mesh.BoundingRadius = std::max(mesh.BoundingRadius, std::sqrt(outer[i].x * outer[i].x + outer[i].y * outer[i].y));
+		}
+
+		mesh.Outline.reserve(count * 6);
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t next = (i + 1) % count;
+
+			mesh.Outline.push_back(polygon[i]);
+			mesh.Outline.push_back(outer[i]);
+			mesh.Outline.push_back(polygon[next]);
+
+			mesh.Outline.push_back(outer[i]);
+			mesh.Outline.push_back(outer[next]);
+			mesh.Outline.push_back(polygon[next]);
+		}
+	}
+
+}
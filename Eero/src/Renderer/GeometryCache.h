@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	// Triangle lists of a regular polygon and its outline, relative to the center
+	struct ShapeMesh
+	{
+		std::vector<sf::Vector2f> Fill;
+		std::vector<sf::Vector2f> Outline;
+		float BoundingRadius = 0.0f; // outline included
+	};
+
+	// Every distinct (radius, points, thickness) is built once and shared by all shapes using it.
+	// Meshes are never freed, the game only ever uses a handful of them.
+	class GeometryCache
+	{
+	public:
+		static const ShapeMesh* Get(float radius, int points, float thickness);
+	private:
+		struct Key
+		{
+			float Radius;
+			int Points;
+			float Thickness;
+
+			bool operator == (const Key& other) const { return Radius == other.Radius && Points == other.Points && Thickness == other.Thickness; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator () (const Key& key) const;
+		};
+
+		static void Build(ShapeMesh& mesh, float radius, int points, float thickness);
+	private:
+		static std::mutex s_Mutex;
+		static std::unordered_map<Key, ShapeMesh, KeyHash> s_Meshes; // nodes, so mesh pointers stay valid
+	};
+
+}
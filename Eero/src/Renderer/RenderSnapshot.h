@@ -0,0 +1,95 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "GeometryCache.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace Eero {
+
+	struct ShapeSnapshot
+	{
+		const ShapeMesh* Mesh = nullptr;
+		float PrevX = 0.0f, PrevY = 0.0f, PrevAngle = 0.0f;
+		float X = 0.0f, Y = 0.0f, Angle = 0.0f;
+		float Scale = 1.0f;
+		sf::Color FillColor;
+		sf::Color OutlineColor;
+	};
+
+	struct TextSnapshot
+	{
+		sf::Text Text;
+		std::shared_ptr<sf::Font> Font; // keeps the font alive while the text is drawn
+	};
+
+	// Render data of one simulation step. The vectors only ever grow, so once they're
+	// big enough filling a snapshot doesn't allocate.
+	struct RenderSnapshot
+	{
+		std::vector<ShapeSnapshot> Shapes;
+		std::vector<TextSnapshot> Texts; // only the first TextCount are used
+		uint32_t TextCount = 0;
+		uint32_t TransparentShapes = 0;
+		std::chrono::steady_clock::time_point PublishTime;
+		std::chrono::steady_clock::time_point InputTime = NoInput; // earliest input the snapshot is the first to show
+
+		static constexpr std::chrono::steady_clock::time_point NoInput = std::chrono::steady_clock::time_point::max();
+
+		void Clear()
+		{
+			Shapes.clear();
+			TextCount = 0;
+			TransparentShapes = 0;
+			InputTime = NoInput;
+		}
+
+		// Reuses the sf::Text of an earlier frame when there is one
+		TextSnapshot& PushText()
+		{
+			if (TextCount == Texts.size())
+				Texts.emplace_back();
+
+			return Texts[TextCount++];
+		}
+	};
+
+	// Lock-free triple buffer. The producer always has a buffer to write to and the consumer
+	// always has the latest complete one, the third one is swapped between them atomically.
+	class SnapshotBuffer
+	{
+	public:
+		// Producer side
+		RenderSnapshot& GetWriteBuffer() { return m_Buffers[m_Write]; }
+		void Publish()
+		{
+			m_Write = m_Shared.exchange(m_Write | s_FreshBit, std::memory_order_acq_rel) & ~s_FreshBit;
+		}
+
+		// Consumer side, switches to the latest published snapshot if there's a new one
+		bool Acquire()
+		{
+			if ((m_Shared.load(std::memory_order_relaxed) & s_FreshBit) == 0)
+				return false;
+
+			m_Read = m_Shared.exchange(m_Read, std::memory_order_acq_rel) & ~s_FreshBit;
+			return true;
+		}
+
+		RenderSnapshot& GetReadBuffer() { return m_Buffers[m_Read]; }
+	private:
+		static constexpr uint32_t s_FreshBit = 4;
+
+		std::array<RenderSnapshot, 3> m_Buffers;
+		uint32_t m_Write = 0;
+		uint32_t m_Read = 1;
+		std::atomic<uint32_t> m_Shared = 2;
+	};
+
+}
@@ -0,0 +1,120 @@
+#include "RenderThread.h"
+
+#include "Core/Profiler.h"
+
+#include <algorithm>
+
+namespace Eero {
+
+	RenderThread::~RenderThread()
+	{
+		Stop();
+	}
+
+	void RenderThread::Start()
+	{
+		if (m_Running)
+			return;
+
+		m_Running = true;
+		m_Thread = std::thread(&RenderThread::Loop, this);
+	}
+
+	void RenderThread::Stop()
+	{
+		if (!m_Running)
+			return;
+
+		m_Running = false;
+		m_Thread.join();
+	}
+
+	RenderStats RenderThread::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(m_StatsMutex);
+		return m_Stats;
+	}
+
+	LatencyStats RenderThread::GetLatency()
+	{
+		std::lock_guard<std::mutex> lock(m_StatsMutex);
+		return m_Latency;
+	}
+
+	void RenderThread::Loop()
+	{
+		// The input thread created the window and released its context
+		auto& renderWindow = m_Window->GetWindow();
+		renderWindow->setActive(true);
+
+		RenderStats stats;
+
+		while (m_Running)
+		{
+			EERO_PROFILE_SCOPE("RenderFrame");
+
+			bool fresh = m_Snapshots.Acquire();
+			RenderSnapshot& snapshot = m_Snapshots.GetReadBuffer();
+
+			// How far the frame is past the step the snapshot was taken at
+			std::chrono::duration<float> sincePublish = std::chrono::steady_clock::now() - snapshot.PublishTime;
+			float alpha = std::clamp(sincePublish.count() / m_Timestep, 0.0f, 1.0f);
+
+			sf::FloatRect view = GetViewBounds();
+
+			m_Window->Clear();
+
+			m_Renderer.Build(snapshot, alpha, view, stats);
+			m_Renderer.Flush(*renderWindow);
+
+			for (uint32_t i = 0; i < snapshot.TextCount; i++)
+			{
+				auto& text = snapshot.Texts[i].Text;
+
+				if (text.getFillColor().a == 0 || !view.intersects(text.getGlobalBounds()))
+				{
+					stats.TextsCulled++;
+					continue;
+				}
+
+				renderWindow->draw(text);
+				stats.TextsDrawn++;
+			}
+
+			stats.DrawCalls = m_Renderer.GetDrawCalls() + stats.TextsDrawn;
+
+			{
+				EERO_PROFILE_SCOPE("Display");
+				m_Window->Display();
+			}
+
+			// Only the first frame showing a snapshot counts its input
+			stats.InputLatency = 0.0f;
+			if (fresh && snapshot.InputTime != RenderSnapshot::NoInput)
+			{
+				std::chrono::duration<float> latency = std::chrono::steady_clock::now() - snapshot.InputTime;
+				stats.InputLatency = latency.count();
+			}
+
+			std::lock_guard<std::mutex> lock(m_StatsMutex);
+			m_Stats = stats;
+
+			if (stats.InputLatency > 0.0f)
+			{
+				m_Latency.Samples++;
+				m_Latency.Total += stats.InputLatency;
+				m_Latency.Max = std::max(m_Latency.Max, stats.InputLatency);
+			}
+		}
+
+		renderWindow->setActive(false);
+	}
+
+	sf::FloatRect RenderThread::GetViewBounds() const
+	{
+		// Bounding box of the view, rotated views included
+		const sf::View& view = m_Window->GetWindow()->getView();
+		return view.getInverseTransform().transformRect({ -1.0f, -1.0f, 2.0f, 2.0f });
+	}
+
+}
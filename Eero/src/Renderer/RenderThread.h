@@ -0,0 +1,62 @@
+#pragma once
+
+#include "BatchRenderer.h"
+#include "RenderSnapshot.h"
+
+#include "Window/Window.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace Eero {
+
+	struct LatencyStats
+	{
+		uint32_t Samples = 0;
+		float Total = 0.0f; // seconds
+		float Max = 0.0f;
+
+		float GetAverage() const { return Samples > 0 ? Total / Samples : 0.0f; }
+	};
+
+	// Draws on its own thread so frame N is drawn while frame N+1 is simulated. The simulation
+	// fills the write snapshot at the end of its steps and publishes it, the render thread
+	// always draws the latest published one. The window's context lives on this thread.
+	class RenderThread
+	{
+	public:
+		RenderThread(const std::shared_ptr<Window>& window, float timestep)
+			: m_Window(window), m_Timestep(timestep) {}
+		~RenderThread();
+
+		void Start();
+		void Stop();
+
+		// Simulation thread only
+		RenderSnapshot& GetWriteSnapshot() { return m_Snapshots.GetWriteBuffer(); }
+		void PublishSnapshot() { m_Snapshots.Publish(); }
+
+		RenderStats GetStats();
+
+		// Input-to-present latency over every frame that showed new input
+		LatencyStats GetLatency();
+	private:
+		void Loop();
+		sf::FloatRect GetViewBounds() const;
+	private:
+		std::shared_ptr<Window> m_Window;
+		float m_Timestep = 0.0f;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running = false;
+
+		SnapshotBuffer m_Snapshots;
+		BatchRenderer m_Renderer;
+
+		std::mutex m_StatsMutex;
+		RenderStats m_Stats;
+		LatencyStats m_Latency;
+	};
+
+}
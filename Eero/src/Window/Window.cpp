@@ -2,17 +2,19 @@
 
 namespace Eero {
 
-	Window::Window(const std::string& title, float width, float height)
-		: m_Width(width), m_Height(height) 
-	{
-		Init(title, width, height);
-	}
+	Window::Window(const std::string& title, float width, float height, bool headless)
+		: m_Title(title), m_Width(width), m_Height(height), m_Headless(headless) {}
 
 	Window::~Window()
 	{
 		Shutdown();
 	}
 
+	void Window::Open()
+	{
+		if (!m_Headless && !m_Window)
+			Init(m_Title, m_Width, m_Height);
+	}
 
 	void Window::Init(const std::string& title, float width, float height)
 	{
@@ -22,17 +24,20 @@ namespace Eero {
 
 	void Window::Shutdown()
 	{
-		m_Window->close();
+		if (m_Window)
+			m_Window->close();
 	}
 
 	void Window::Clear()
 	{
-		m_Window->clear(sf::Color::Black);
+		if (m_Window)
+			m_Window->clear(sf::Color::Black);
 	}
 
 	void Window::Display()
 	{
-		m_Window->display();
+		if (m_Window)
+			m_Window->display();
 	}
 
 	void Window::SetSize(float width, float height)
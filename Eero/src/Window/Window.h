@@ -7,13 +7,18 @@ namespace Eero {
 	class Window
 	{
 	public:
-		Window(const std::string& title, float width, float height);
+		// A headless window only keeps the size around, there's nothing to draw to
+		Window(const std::string& title, float width, float height, bool headless = false);
 		~Window();
 
+		// Creates the sf::RenderWindow, its events can only be polled on the calling thread
+		void Open();
+
 		void Clear();
 		void Display();
 
-		std::shared_ptr<sf::RenderWindow>& GetWindow() { return m_Window; } // actual sf::RenderWindow
+		std::shared_ptr<sf::RenderWindow>& GetWindow() { return m_Window; } // actual sf::RenderWindow, null until opened and when headless
+		bool IsHeadless() const { return m_Headless; }
 
 		void Shutdown();
 
@@ -23,7 +28,9 @@ namespace Eero {
 		void Init(const std::string& title, float width, float height);
 	private:
 		std::shared_ptr<sf::RenderWindow> m_Window;
+		std::string m_Title;
 		float m_Width, m_Height = 0.0f;
+		bool m_Headless = false;
 	};
 
 }
@@ -48,4 +48,10 @@ project "Sandbox"
          "sfml-system-s",
          "sfml-audio-s",
          "sfml-network-s"
-      }
\ No newline at end of file
+      }
+
+   filter "options:profile"
+      defines { "EERO_PROFILE" }
+
+   filter "options:track-allocations"
+      defines { "EERO_TRACK_ALLOCATIONS" }
\ No newline at end of file
@@ -1,43 +1,70 @@
 #include "Game.h"
 
+#include <iostream>
+
 namespace Eero {
 
 	Game::Game()
-	: m_Entities(Application::GetEntities()), m_Input(Application::GetInput()), m_Collision(Application::GetCollision()) {}
+	: Layer("Game"), m_Entities(Application::GetEntities()), m_Input(Application::GetInput()), m_Collision(Application::GetCollision()),
+	  m_Particles(Application::GetParticles()) {}
 
 	void Game::OnAttach()
 	{
+		m_PlayerTag = m_Entities->RegisterTag("player");
+		m_EnemyTag = m_Entities->RegisterTag("enemy");
+		m_BulletTag = m_Entities->RegisterTag("bullet");
+
+		Collisions();
+
+		// Runs in the system graph after the engine systems that touch transforms
+		Application::GetScheduler()->AddSystem("RotateEntities", Reads<>(), Writes<TransformComponent>(),
+			[this](float deltaTime) { RotateEntities(deltaTime); });
+
 		SpawnPlayer();
 		SpawnEnemy();
 
 		auto scoreText = m_Entities->PushEntity("scoreText");
-		scoreText->cText = std::make_shared<TextComponent>("assets/Orbitron-Regular.ttf", "Score: 0", Vec2(30.0f, 30.0f), Vec3(255, 255, 255), 24);
+		scoreText.AddComponent<TextComponent>("assets/Orbitron-Regular.ttf", "Score: 0", Vec2(30.0f, 30.0f), Vec3(255, 255, 255), 24);
 
 		m_ScoreText = scoreText;
+
+		ScheduleSpawn();
 	}
 
-	void Game::OnUpdate(float deltaTime)
+	void Game::OnUpdate(float)
 	{
 		UserInput();
-		Collisions();
-		RotateEntities(deltaTime);
 
-		if (m_EnemySpawnTimer >= Time::Seconds(3)) // > in case of the frames wont match
+		m_Timers.Advance(1, [&](uint64_t timer)
 		{
-			if (m_Paused)
-			{
-				SpawnPlayer();
-				m_Paused = false;
-			}
-			else
+			switch ((GameTimer)timer)
 			{
-				SpawnEnemy();
+				case GameTimer::Spawn:
+				{
+					if (m_Paused)
+					{
+						SpawnPlayer();
+						m_Paused = false;
+					}
+					else
+					{
+						SpawnEnemy();
+					}
+
+					ScheduleSpawn();
+					break;
+				}
+
+				default:
+					break;
 			}
+		});
+	}
 
-			m_EnemySpawnTimer = 0;
-		}
-
-		m_EnemySpawnTimer++;
+	void Game::ScheduleSpawn()
+	{
+		m_Timers.Cancel(m_SpawnTimer);
+		m_SpawnTimer = m_Timers.Schedule(Time::Seconds(3), (uint64_t)GameTimer::Spawn);
 	}
 
 	void Game::Restart()
@@ -47,138 +74,134 @@ namespace Eero {
 
 		m_Paused = true;
 
-		for (auto& entity : m_Entities->GetEntities())
+		for (auto entity : m_Entities->GetEntities())
 		{
-			if (entity->cTransform != nullptr)
-				entity->cTransform->Velocity = { 0.0f, 0.0f };
+			if (entity.HasComponent<TransformComponent>())
+				entity.GetComponent<TransformComponent>().Velocity = { 0.0f, 0.0f };
 
-			entity->cLifespan = std::make_shared<LifespanComponent>(Time::Seconds(0.5), Time::Seconds(0.5), LifespanComponent::EffectTypes::Fade);
+			entity.AddComponent<LifespanComponent>(Time::Seconds(0.5), Time::Seconds(0.5), LifespanComponent::EffectTypes::Fade);
 		}
 
-		m_EnemySpawnTimer = 0;
+		ScheduleSpawn();
 	}
 
 	void Game::AddScore()
 	{
-		m_ScoreText->cText->SetText("Score: " + std::to_string(m_Score+= 100));
+		m_ScoreText.GetComponent<TextComponent>().SetText("Score: " + std::to_string(m_Score+= 100));
 	}
 
 	void Game::SpawnPlayer()
 	{
-		auto entity = m_Entities->PushEntity("player");
+		auto entity = m_Entities->PushEntity(m_PlayerTag);
 
-		entity->cShape = std::make_shared<ShapeComponent>(64.0f, 8, Vec3(10, 10, 10), Vec3(255, 0, 0), 4.0f);
+		entity.AddComponent<ShapeComponent>(64.0f, 8, Vec3(10, 10, 10), Vec3(255, 0, 0), 4.0f);
 
 		auto [x, y] = Application::GetWindow()->GetSize();
-		entity->cTransform = std::make_shared<TransformComponent>(Vec2(x / 2, y / 2), Vec2(0.0f, 0.0f), 0.0f);
+		entity.AddComponent<TransformComponent>(Vec2(x / 2, y / 2), Vec2(0.0f, 0.0f), 0.0f);
 		
-		entity->cCollision = std::make_shared<CollisionComponent>(64.0f);
+		entity.AddComponent<CollisionComponent>(64.0f);
 
 		m_Player = entity;
 	}
 
 	void Game::SpawnEnemy()
 	{
-		auto entity = m_Entities->PushEntity("enemy");
+		auto entity = m_Entities->PushEntity(m_EnemyTag);
 
 		// Shape
-		entity->cShape = std::make_shared<ShapeComponent>(64.0f, Random::Calculate(8, 3), Vec3(10, 10, 10), Vec3(Random::Calculate(255, 1), Random::Calculate(255, 1), Random::Calculate(255, 1)), 4.0f);
+		auto& shape = entity.AddComponent<ShapeComponent>(64.0f, Random::Calculate(8, 3), Vec3(10, 10, 10), Vec3(Random::Calculate(255, 1), Random::Calculate(255, 1), Random::Calculate(255, 1)), 4.0f);
 
 		// Position
 		auto& window = Application::GetWindow();
 		auto [x, y] = window->GetSize();
-		float radius = entity->cShape->Circle.getRadius();
+		float radius = shape.Radius;
 
 		float posX = Random::Calculate(x - radius, radius);
 		float posY = Random::Calculate(y - radius, radius);
 
-		entity->cTransform = std::make_shared<TransformComponent>(Vec2(posX, posY), Vec2(300.0f, 300.0f), 0.0f);
+		entity.AddComponent<TransformComponent>(Vec2(posX, posY), Vec2(300.0f, 300.0f), 0.0f);
 
 		// Collision
-		entity->cCollision = std::make_shared<CollisionComponent>(64.0f);
+		entity.AddComponent<CollisionComponent>(64.0f);
 	}
 
 	void Game::SpawnBullet()
 	{
-		auto entity = m_Entities->PushEntity("bullet");
+		auto entity = m_Entities->PushEntity(m_BulletTag);
 
 		// Shape
-		entity->cShape = std::make_shared<ShapeComponent>(16.0f, 32, Vec3(255, 255, 255), Vec3(255, 0, 0), 4.0f);
+		entity.AddComponent<ShapeComponent>(16.0f, 32, Vec3(255, 255, 255), Vec3(255, 0, 0), 4.0f);
 		
 		// Transform
-		entity->cTransform = std::make_shared<TransformComponent>(Vec2(m_Player->cTransform->Pos.x, m_Player->cTransform->Pos.y), Vec2(0.0f, 0.0f), 0.0f);
+		Vec2 playerPos = m_Player.GetComponent<TransformComponent>().Pos;
+		auto& transform = entity.AddComponent<TransformComponent>(playerPos, Vec2(0.0f, 0.0f), 0.0f);
 
 		auto [mouseX, mouseY] = m_Input->GetMousePosition();
-		float playerX = m_Player->cTransform->Pos.x;
-		float playerY = m_Player->cTransform->Pos.y;
 
 		Vec2 mousePos = { mouseX, mouseY };
-		Vec2 playerPos = { playerX, playerY };
 
 		Vec2 difference = mousePos - playerPos;
 		Vec2 normal = { difference.x / difference.length(), difference.y / difference.length() };
-		entity->cTransform->Velocity = { 600.0f * normal.x, 600.0f * normal.y };
+		transform.Velocity = { 600.0f * normal.x, 600.0f * normal.y };
  
 		// Lifespan
-		entity->cLifespan = std::make_shared<LifespanComponent>(Time::Seconds(0.8), Time::Seconds(0.5), LifespanComponent::EffectTypes::Fade);
+		entity.AddComponent<LifespanComponent>(Time::Seconds(0.8), Time::Seconds(0.5), LifespanComponent::EffectTypes::Fade);
 
 		// Collision
-		entity->cCollision = std::make_shared<CollisionComponent>(16.0f);
+		entity.AddComponent<CollisionComponent>(16.0f);
 	}
 
-	void Game::DestroyEnemyEffect(std::shared_ptr<Entity>& enemy)
+	void Game::DestroyEnemyEffect(Entity enemy)
 	{
-		auto& enemyShape = enemy->cShape;
-		Vec3 enemyFillColor = enemyShape->GetFillColor();
-		Vec3 enemyOutlineColor = enemyShape->GetOutlineColor();
-		Vec2 enemyPos = enemy->cTransform->Pos;
-		int points = enemyShape->GetPointCount();
-
-		int angle = 360 / points;
-		int actualAngle = 0;
-
-		for (int i = 0; i < points; i++)
-		{
-			actualAngle += angle;
-			Vec2 circlePoint = { enemyPos.x + (float)cos(actualAngle * (3.14159 / 180)), enemyPos.y + (float)sin(actualAngle * (3.14159 / 180)) };
-			Vec2 difference = circlePoint - enemyPos;
-			Vec2 normal = { difference.x / difference.length(), difference.y / difference.length() };
-
-			auto effectEntity = m_Entities->PushEntity("effectEntity");
-			effectEntity->cShape = std::make_shared<ShapeComponent>(16.0f, points, enemyFillColor, enemyOutlineColor, 4.0f);
-			effectEntity->cTransform = std::make_shared<TransformComponent>(enemyPos, Vec2(300.0f * normal.x, 300.0f * normal.y), 0.0f);
-			effectEntity->cLifespan = std::make_shared<LifespanComponent>(Time::Seconds(0.6), Time::Seconds(0.4), LifespanComponent::EffectTypes::Fade);
-		}
+		auto& enemyShape = enemy.GetComponent<ShapeComponent>();
+
+		// One small shape per corner of the enemy, flying out and fading
+		ParticleEmitter emitter;
+		emitter.Count = enemyShape.Points;
+		emitter.Speed = 300.0f;
+		emitter.Lifetime = 0.6f;
+		emitter.FadeTime = 0.4f;
+		emitter.Spin = 100.0f;
+		emitter.Radius = 16.0f;
+		emitter.Points = enemyShape.Points;
+		emitter.Thickness = 4.0f;
+		emitter.FillColor = enemyShape.FillColor;
+		emitter.OutlineColor = enemyShape.OutlineColor;
+
+		m_Particles->Emit(emitter, enemy.GetComponent<TransformComponent>().Pos);
 	}
 
 	void Game::RotateEntities(float deltaTime)
 	{
-		for (auto& entity : m_Entities->GetEntities())
+		m_Entities->Each<TransformComponent>([&](Entity, TransformComponent& transform)
 		{
-			if (entity->cTransform != nullptr)
-				entity->cTransform->Angle += 100.0f * deltaTime;
-		}
+			transform.Angle += 100.0f * deltaTime;
+		});
 	}
 
 	void Game::UserInput()
 	{
+		// The handle goes stale once the player has faded out on restart
+		if (!m_Player.IsActive())
+			return;
+
 		if (m_Input->KeyPressed(KEY_W))
-			m_Player->cTransform->Velocity.y = -300.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.y = -300.0f;
 		if (m_Input->KeyPressed(KEY_S))
-			m_Player->cTransform->Velocity.y = 300.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.y = 300.0f;
 		if (m_Input->KeyPressed(KEY_A))
-			m_Player->cTransform->Velocity.x = -300.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.x = -300.0f;
 		if (m_Input->KeyPressed(KEY_D))
-			m_Player->cTransform->Velocity.x = 300.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.x = 300.0f;
 
 		if (m_Input->KeyReleased(KEY_W))
-			m_Player->cTransform->Velocity.y = 0.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.y = 0.0f;
 		if (m_Input->KeyReleased(KEY_S))
-			m_Player->cTransform->Velocity.y = 0.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.y = 0.0f;
 		if (m_Input->KeyReleased(KEY_A))
-			m_Player->cTransform->Velocity.x = 0.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.x = 0.0f;
 		if (m_Input->KeyReleased(KEY_D))
-			m_Player->cTransform->Velocity.x = 0.0f;
+			m_Player.GetComponent<TransformComponent>().Velocity.x = 0.0f;
 
 		if (m_Input->MouseButtonPressed(MOUSE_1))
 			SpawnBullet();
@@ -186,19 +209,19 @@ namespace Eero {
 
 	void Game::Collisions()
 	{
-		m_Collision->CheckCollision("enemy", "bullet", [&](EntityPairs entities)
+		m_Collision->OnCollision(m_EnemyTag, m_BulletTag, [&](EntityPairs entities)
 		{
 			auto& [entityX, entityY] = entities;
 
-			entityX->cLifespan = std::make_shared<LifespanComponent>(Time::Seconds(0.15), Time::Seconds(0.15), LifespanComponent::EffectTypes::Fade);
+			entityX.AddComponent<LifespanComponent>(Time::Seconds(0.15), Time::Seconds(0.15), LifespanComponent::EffectTypes::Fade);
 			DestroyEnemyEffect(entityX);
 
-			entityY->Destroy();
+			entityY.Destroy();
 
 			AddScore();
 		});
 
-		m_Collision->CheckCollision("enemy", "player", [&](EntityPairs entities)
+		m_Collision->OnCollision(m_EnemyTag, m_PlayerTag, [&](EntityPairs entities)
 		{
 			auto& [entityX, entityY] = entities;
 
@@ -206,9 +229,75 @@ namespace Eero {
 		});
 	}
 
-	std::shared_ptr<Application> CreateApplication()
+	// Stands in for the player in headless runs, walks around and keeps shooting
+	static void ScriptedInput(uint32_t frame, EventHandler& events)
 	{
-		AppProps props = {"Geometry Wars", 1280.0f, 720.0f};
+		static const sf::Keyboard::Key s_Keys[] = { KEY_W, KEY_D, KEY_S, KEY_A };
+
+		if (frame % 60 == 0 || frame % 60 == 30)
+		{
+			sf::Event event;
+			event.type = frame % 60 == 0 ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+			event.key = {};
+			event.key.code = s_Keys[(frame / 60) % 4];
+			events.Push(event);
+		}
+
+		if (frame % 10 == 0)
+		{
+			float angle = frame * 0.1f;
+
+			sf::Event event;
+			event.type = sf::Event::MouseButtonPressed;
+			event.mouseButton.button = MOUSE_1;
+			event.mouseButton.x = (int)(640.0f + 500.0f * std::cos(angle));
+			event.mouseButton.y = (int)(360.0f + 300.0f * std::sin(angle));
+			events.Push(event);
+		}
+	}
+
+	std::shared_ptr<Application> CreateApplication(const CommandLineArgs& args)
+	{
+		AppProps props;
+		props.WindowTitle = "Geometry Wars";
+		props.WindowWidth = 1280.0f;
+		props.WindowHeight = 720.0f;
+
+		// --headless [frames] [--batch], the scripted input never quits so 0 frames isn't allowed
+		int headless = args.Find("--headless");
+		if (headless >= 0)
+		{
+			props.Headless = true;
+			props.HeadlessBatch = args.Find("--batch") >= 0;
+			props.InputSource = ScriptedInput;
+
+			uint32_t frames = 0;
+			if (args.GetNumber(headless + 1, frames))
+			{
+				if (frames > 0)
+					props.HeadlessFrames = frames;
+				else
+					std::cout << "Headless: the scripted input never quits, running the default " << props.HeadlessFrames << " frames" << std::endl;
+			}
+		}
+
+		// --verify-collision [seed], checks the collision modes against each other and exits
+		int verify = args.Find("--verify-collision");
+		if (verify >= 0)
+		{
+			props.Headless = true;
+			props.VerifyCollision = true;
+			args.GetNumber(verify + 1, props.VerifySeed);
+		}
+
+		// --latency
+		props.ReportLatency = args.Find("--latency") >= 0;
+
+		// --alloc-budget allocations, needs a --track-allocations build
+		int budget = args.Find("--alloc-budget");
+		if (budget >= 0)
+			args.GetNumber(budget + 1, props.AllocationBudget);
+
 		std::shared_ptr<Application> app = std::make_shared<Application>(props);
 
 		app->PushLayer<Game>();
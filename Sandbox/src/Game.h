@@ -20,22 +20,37 @@ namespace Eero {
 		void SpawnEnemy();
 		void SpawnBullet();
 
-		void DestroyEnemyEffect(std::shared_ptr<Entity>& enemey);
+		void DestroyEnemyEffect(Entity enemy);
 		void RotateEntities(float deltaTime);
 
 		void UserInput();
 		void Collisions();
+
+		void ScheduleSpawn();
 	private:
 		std::shared_ptr<EntityManager> m_Entities;
 		std::shared_ptr<Input> m_Input;
 		std::shared_ptr<Collision> m_Collision;
+		std::shared_ptr<ParticleSystem> m_Particles;
+
+		Entity m_Player;
+		Entity m_ScoreText;
 
-		std::shared_ptr<Entity> m_Player;
-		std::shared_ptr<Entity> m_ScoreText;
+		TagID m_PlayerTag = InvalidTag;
+		TagID m_EnemyTag = InvalidTag;
+		TagID m_BulletTag = InvalidTag;
 
 		bool m_Paused = false;
 		int m_Score = 0;
-		int m_EnemySpawnTimer = 0;
+
+		// Gameplay timers, advanced once per step
+		enum class GameTimer : uint64_t
+		{
+			Spawn = 0
+		};
+
+		TimerWheel m_Timers;
+		TimerHandle m_SpawnTimer;
 	};
 
 }
@@ -3,6 +3,16 @@ workspace "Eero"
    configurations { "Debug", "Release" }
    startproject "Sandbox"
 
+newoption {
+   trigger = "profile",
+   description = "Build the zone profiler in, writes a Chrome trace at shutdown"
+}
+
+newoption {
+   trigger = "track-allocations",
+   description = "Count heap allocations per frame and per profiler zone"
+}
+
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 include "Eero"